@@ -5,11 +5,14 @@
 #include "Engine/Engine.h"
 #include "Components/CapsuleComponent.h"
 #include "Kismet/GameplayStatics.h"
+#include "Subsystems/GrapplePointSubsystem.h"
+#include "Characters/Components/ParkourMovementComponent.h"
 
 UGrapplingHookComponent::UGrapplingHookComponent()
 {
+    // Ticks every frame while grappling, so the cable follows the rope the movement component swings
     PrimaryComponentTick.bCanEverTick = true;
-    PrimaryComponentTick.TickInterval = 0.1f;
+    SetIsReplicatedByDefault(true);
     GrapplePullAudioComponent = CreateDefaultSubobject<UAudioComponent>(TEXT("GrapplePullAudio"));
     GrapplePullAudioComponent->bAutoActivate = false;
 }
@@ -20,114 +23,338 @@ void UGrapplingHookComponent::BeginPlay()
     
 	CurrentCooldown = GrappleCooldown;
     OriginalCapsuleHalfHeight = OwnerCharacter->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+    GrapplePoints = GetWorld()->GetSubsystem<UGrapplePointSubsystem>();
+    PreviewReuseCos = FMath::Cos(FMath::DegreesToRadians(PreviewReuseAngle));
+    PreviewTraceDelegate.BindUObject(this, &UGrapplingHookComponent::OnPreviewTraceDone);
 }
 
-void UGrapplingHookComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UGrapplingHookComponent::ComputeTick(const float DeltaTime, const FParkourRunnerState& State)
 {
-    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
     if (bIsMantling)
     {
-        UpdateMantle(DeltaTime);
+        MantleAlpha += DeltaTime / MantleDuration;
         return;
     }
-    if (!bIsGrappling || CurrentCooldown <= 0.0f)
+    if (!bIsGrappling || bIsProxyGrapple || CurrentCooldown <= 0.0f)
         return;
 
+    // Swinging and reeling run in UParkourMovementComponent::PhysRope; the pull ends where the planned sweep first hit,
+    // contact with anything else on the way is left to the rope's own slide. Running out of time only lets go
     CurrentCooldown -= DeltaTime;
-    const FVector ToTarget = GrappleLocation - OwnerCharacter->GetActorLocation();
-    Distance = ToTarget.Length();
-    
-    // Apply continuous pulling force
-    const FVector PullDirection = ToTarget.GetSafeNormal();
-    const float PullStrength = CalculatePullStrength(ToTarget);
-    const FVector PullForce = PullDirection * PullStrength * DeltaTime;
-    MovementComponent->AddImpulse(PullForce, true);
-    
-    if (ShouldApplyAntiGravity(ToTarget))
-        MovementComponent->AddImpulse(FVector(0, 0, HorizontalAntiGravityForce * DeltaTime), true);
-    
-    if (CurrentCooldown <= 0.0f || Distance < ReleaseDistance)
-    {
+    bPendingClimb = FVector::DistSquared(State.Location, Path.End) <= FMath::Square(ReleaseDistance);
+    bPendingRelease = CurrentCooldown <= 0.0f;
+    if (bPendingRelease)
         CurrentCooldown = GrappleCooldown;
-        ClimbAtEnd();
+}
+
+void UGrapplingHookComponent::ApplyTick(const float DeltaTime)
+{
+    if (bIsMantling)
+    {
+        UpdateMantle();
+        return;
     }
-    
-    UpdateCableVisuals(DeltaTime);
+    // Passing the end of the path on a slack rope (swinging, reeling out) is not the end of the pull
+    if (bPendingClimb && OwnerCharacter->GetParkourMovement()->GetRope().Length <= Path.EndRopeLength)
+        ClimbAtEnd();
+    else if (bPendingRelease)
+        ReleaseGrapple();
+    bPendingClimb = false;
+    bPendingRelease = false;
+    if (bIsGrappling)
+        UpdateCableVisuals();
+}
+
+void UGrapplingHookComponent::SetReelInput(const float Axis)
+{
+    if (!bIsGrappling || bIsProxyGrapple)
+        return;
+    const float Input = Axis == 0.0f && bAutoReelIn ? 1.0f : Axis;
+    const float Rate = Input >= 0.0f ? Input * ReelInSpeed : Input * ReelOutSpeed;
+    OwnerCharacter->GetParkourMovement()->SetRopeReelRate(Rate);
 }
 
-void UGrapplingHookComponent::TryShoot()
+bool UGrapplingHookComponent::TryShoot()
 {
-    if (bIsGrappling) return;
+    if (bIsGrappling || bIsMantling) return false;
     if (GrappleStart)
         UGameplayStatics::PlaySoundAtLocation(GetWorld(), GrappleStart, OwnerCharacter->GetActorLocation());
-    const APlayerController* PC = Cast<APlayerController>(OwnerCharacter->GetController());
-    if (!PC) return;
     
+    // Players aim with the camera; runners without a player controller (benchmark crowd, AI) aim along their eyes
     FVector CameraLocation;
     FRotator CameraRotation;
-    PC->GetPlayerViewPoint(CameraLocation, CameraRotation);
+    if (const APlayerController* PC = Cast<APlayerController>(OwnerCharacter->GetController()))
+        PC->GetPlayerViewPoint(CameraLocation, CameraRotation);
+    else
+        OwnerCharacter->GetActorEyesViewPoint(CameraLocation, CameraRotation);
+
+    // A fresh preview from the same view already answered the question; only trace when there is none
+    FVector Target = Preview.Target;
+    const bool bUsePreview = Preview.bValid && IsPreviewCurrent(CameraLocation, CameraRotation.Vector());
+    if (bUsePreview || FindGrappleTarget(CameraLocation, CameraRotation.Vector(), Target))
+    {
+        LOG_RATE_LIMITED(LogParkourGrapple, Log, 1, "Grapple hit at: %s", *Target.ToString());
+        StartGrapple(Target);
+    }
+    else
+    {
+        LOG_VERBOSE(LogParkourGrapple, "Grapple miss - no target found");
+    }
+    
+    CurrentCooldown = GrappleCooldown;
+    return true;
+}
 
-    const FVector Start = CameraLocation;
-    const FVector End = Start + CameraRotation.Vector() * Range;
+bool UGrapplingHookComponent::FindAimAssistCandidate(const FVector& ViewLocation, const FVector& ViewDirection, FVector& OutCandidate) const
+{
+    if (!bUseAimAssist || !GrapplePoints)
+        return false;
     
+    FGrapplePointQuery Query;
+    Query.Origin = ViewLocation;
+    Query.Direction = ViewDirection;
+    Query.Range = Range;
+    Query.CosConeAngle = FMath::Cos(FMath::DegreesToRadians(AimAssistConeAngle));
+    Query.AngleWeight = AimAssistAngleWeight;
+    Query.DistanceWeight = AimAssistDistanceWeight;
+    Query.MinDistance = MinGrappleDistance;
+    Query.MinLedgeHeight = AimAssistMinLedgeHeight;
+    return GrapplePoints->FindBestCandidate(Query, OutCandidate);
+}
+
+bool UGrapplingHookComponent::FindGrappleTarget(const FVector& ViewLocation, const FVector& ViewDirection, FVector& OutTarget) const
+{
     FCollisionQueryParams TraceParams;
     TraceParams.AddIgnoredActor(OwnerCharacter);
-
     FHitResult Hit;
-    if (GetWorld()->LineTraceSingleByChannel(Hit, Start, End, ECC_WorldStatic, TraceParams))
+    
+    // Whatever the crosshair is on wins; aim assist only rescues a shot that would miss
+    if (PARKOUR_QUERY(Grapple, GetWorld()->LineTraceSingleByChannel(Hit, ViewLocation, ViewLocation + ViewDirection * Range, ECC_WorldStatic, TraceParams))
+        && IsValidGrappleHit(ViewLocation, Hit.Location))
+    {
+        OutTarget = Hit.Location;
+        return true;
+    }
+    
+    // Best indexed point in the view cone, confirmed by one trace that may only stop at the point itself
+    FVector Candidate;
+    if (!FindAimAssistCandidate(ViewLocation, ViewDirection, Candidate))
+        return false;
+    const bool bBlocked = PARKOUR_QUERY(Grapple, GetWorld()->LineTraceSingleByChannel(Hit, ViewLocation, Candidate, ECC_WorldStatic, TraceParams));
+    if (bBlocked && FVector::DistSquared(Hit.Location, Candidate) > FMath::Square(AimAssistVisibilityTolerance))
+    {
+        LOG_VERBOSE(LogParkourGrapple, "Aim assist candidate %s is blocked", *Candidate.ToString());
+        return false;
+    }
+    OutTarget = Candidate;
+    return true;
+}
+
+bool UGrapplingHookComponent::IsValidGrappleHit(const FVector& ViewLocation, const FVector& HitLocation) const
+{
+    return FVector::DistSquared(ViewLocation, HitLocation) >= FMath::Square(MinGrappleDistance);
+}
+
+void UGrapplingHookComponent::UpdateAimPreview()
+{
+    const APlayerController* PC = Cast<APlayerController>(OwnerCharacter->GetController());
+    if (!PC || PreviewTraceHandle.IsValid() || bIsGrappling || bIsMantling)
+        return;
+    
+    const uint64 Frame = GFrameCounter;
+    FVector End;
+    if (bPreviewTryAimAssist)
     {
-        UE_LOG(LogTemp, Warning, TEXT("Grapple HIT at: %s"), *Hit.Location.ToString());
-        StartGrapple(Hit.Location);
+        // The crosshair trace for the pending view missed: confirm the candidate picked for that same view
+        PendingPreview.bAimAssist = true;
+        End = PendingPreview.Target;
     }
     else
     {
-        UE_LOG(LogTemp, Warning, TEXT("Grapple MISS - no target found"));
+        FVector ViewLocation;
+        FRotator ViewRotation;
+        PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+        const FVector ViewDirection = ViewRotation.Vector();
+        
+        if (Frame - LastPreviewRequestFrame < static_cast<uint64>(PreviewTraceInterval))
+            return;
+        // Barely moved: the last answer still holds, just keep it alive
+        if (Preview.bHasResult && FVector::DistSquared(ViewLocation, Preview.ViewLocation) <= FMath::Square(PreviewReuseDistance)
+            && (ViewDirection | Preview.ViewDirection) >= PreviewReuseCos)
+        {
+            Preview.Frame = Frame;
+            return;
+        }
+        
+        PendingPreview = FGrapplePreview();
+        PendingPreview.ViewLocation = ViewLocation;
+        PendingPreview.ViewDirection = ViewDirection;
+        PendingPreview.Frame = Frame;
+        End = ViewLocation + ViewDirection * Range;
     }
     
-    CurrentCooldown = GrappleCooldown;
+    FCollisionQueryParams TraceParams;
+    TraceParams.AddIgnoredActor(OwnerCharacter);
+    PreviewTraceHandle = PARKOUR_QUERY(Grapple, GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, PendingPreview.ViewLocation, End, ECC_WorldStatic,
+        TraceParams, FCollisionResponseParams::DefaultResponseParam, &PreviewTraceDelegate));
+    LastPreviewRequestFrame = Frame;
+    bPreviewTryAimAssist = false;
+}
+
+bool UGrapplingHookComponent::IsPreviewCurrent(const FVector& ViewLocation, const FVector& ViewDirection) const
+{
+    return Preview.bHasResult && GFrameCounter - Preview.Frame <= MaxPreviewAgeFrames
+        && FVector::DistSquared(ViewLocation, Preview.ViewLocation) <= FMath::Square(PreviewReuseDistance)
+        && (ViewDirection | Preview.ViewDirection) >= PreviewReuseCos;
+}
+
+void UGrapplingHookComponent::OnPreviewTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+    PreviewTraceHandle = FTraceHandle();
+    const FHitResult* Hit = Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit ? &Datum.OutHits[0] : nullptr;
+    
+    if (PendingPreview.bAimAssist)
+    {
+        PendingPreview.bValid = !Hit || FVector::DistSquared(Hit->Location, PendingPreview.Target) <= FMath::Square(AimAssistVisibilityTolerance);
+    }
+    else if (Hit && IsValidGrappleHit(PendingPreview.ViewLocation, Hit->Location))
+    {
+        PendingPreview.bValid = true;
+        PendingPreview.Target = Hit->Location;
+    }
+    else if (FindAimAssistCandidate(PendingPreview.ViewLocation, PendingPreview.ViewDirection, PendingPreview.Target))
+    {
+        // Keep showing the last result until the candidate's trace is back
+        bPreviewTryAimAssist = true;
+        return;
+    }
+    
+    PendingPreview.bHasResult = true;
+    Preview = PendingPreview;
 }
 
 void UGrapplingHookComponent::StartGrapple(const FVector& TargetLocation)
 {
     bIsGrappling = true;
     GrappleLocation = TargetLocation;
-    if (GrappleAttach)
-        UGameplayStatics::PlaySoundAtLocation(GetWorld(), GrappleAttach, TargetLocation);
-    if (GrapplePullAudioComponent && GrapplePull)
-        GrapplePullAudioComponent->Play();
+    UpdateTickSchedule();
+    StartGrappleEffects();
     
     OwnerCharacter->GetCapsuleComponent()->SetCapsuleHalfHeight(OriginalCapsuleHalfHeight/2);
-    // Initial upward boost
-    OwnerCharacter->LaunchCharacter(FVector(0, 0, InitialUpwardBoost), true, true);
-    MovementComponent->SetMovementMode(MOVE_Flying);
+    PlanPath();
+    // Initial upward boost, then the rope takes over
+    MovementComponent->Velocity = FVector(0, 0, InitialUpwardBoost);
+    OwnerCharacter->GetParkourMovement()->StartRope(TargetLocation, FVector::Dist(TargetLocation, OwnerCharacter->GetActorLocation()));
+    SetReelInput(0.0f);
+    
+    if (ShouldBroadcastEvents())
+        MulticastGrappleStarted(TargetLocation);
+}
+
+void UGrapplingHookComponent::PlanPath()
+{
+    const UCapsuleComponent* Capsule = OwnerCharacter->GetCapsuleComponent();
+    const float CapsuleRadius = Capsule->GetScaledCapsuleRadius();
+    
+    Path = FGrapplePath();
+    Path.Start = OwnerCharacter->GetActorLocation();
+    Path.Direction = (GrappleLocation - Path.Start).GetSafeNormal();
+    
+    // Sweep the grappling capsule along the pull once; the first blocking hit is where the pull will end
+    FCollisionQueryParams TraceParams;
+    TraceParams.AddIgnoredActor(OwnerCharacter);
+    FHitResult Hit;
+    const bool bHit = PARKOUR_QUERY(Grapple, GetWorld()->SweepSingleByChannel(Hit, Path.Start, GrappleLocation, FQuat::Identity, ECC_WorldStatic,
+        FCollisionShape::MakeCapsule(CapsuleRadius, Capsule->GetScaledCapsuleHalfHeight()), TraceParams));
+    Path.End = bHit ? Hit.Location : GrappleLocation;
+    Path.EndRopeLength = FVector::Dist(GrappleLocation, Path.End) + ReleaseDistance;
     
+    // Anything hit well short of the anchor is in the way: the pull stops there and there is nothing to climb onto
+    if (bHit && FVector::Dist(Hit.ImpactPoint, GrappleLocation) > CapsuleRadius + ReleaseDistance)
+    {
+        LOG_VERBOSE(LogParkourGrapple, "Grapple path blocked at %s", *Hit.ImpactPoint.ToString());
+        return;
+    }
+    
+    // Position the mantle target forward from the grapple point
+    Path.bCanMantle = ValidateLandingSpace(GrappleLocation, Path.Direction);
+    Path.MantleTarget = GrappleLocation + Path.Direction * (CapsuleRadius + 40.0f);
+    Path.MantleTarget.Z += OriginalCapsuleHalfHeight + 10.0f;
+}
+
+void UGrapplingHookComponent::StartGrappleEffects()
+{
+    if (GrappleAttach)
+        UGameplayStatics::PlaySoundAtLocation(GetWorld(), GrappleAttach, GrappleLocation);
+    if (GrapplePullAudioComponent && GrapplePull)
+        GrapplePullAudioComponent->Play();
     if (UCableComponent* Cable = OwnerCharacter->GetCable())
         Cable->SetVisibility(true);
 }
 
-void UGrapplingHookComponent::UpdateCableVisuals(float DeltaTime) const
+void UGrapplingHookComponent::StopGrappleEffects()
 {
+    if (GrapplePullAudioComponent && GrapplePullAudioComponent->IsPlaying())
+        GrapplePullAudioComponent->Stop();
     if (UCableComponent* Cable = OwnerCharacter->GetCable())
-        Cable->SetWorldLocation(FMath::VInterpTo(Cable->GetComponentLocation(), GrappleLocation, DeltaTime, CableInterpSpeed));
+        Cable->SetVisibility(false);
+}
+
+void UGrapplingHookComponent::MulticastGrappleStarted_Implementation(const FVector_NetQuantize TargetLocation)
+{
+    // Proxy movement comes from replicated movement, the event only brings up the cable
+    if (!IsSimulatedProxy() || bIsGrappling)
+        return;
+    
+    bIsGrappling = true;
+    bIsProxyGrapple = true;
+    GrappleLocation = TargetLocation;
+    UpdateTickSchedule();
+    StartGrappleEffects();
+}
+
+void UGrapplingHookComponent::MulticastGrappleReleased_Implementation()
+{
+    if (!bIsProxyGrapple)
+        return;
+    
+    bIsGrappling = false;
+    bIsProxyGrapple = false;
+    UpdateTickSchedule();
+    StopGrappleEffects();
+}
+
+void UGrapplingHookComponent::UpdateCableVisuals() const
+{
+    UCableComponent* Cable = OwnerCharacter->GetCable();
+    if (!Cable)
+        return;
+    
+    // Same anchor and length the movement solver swings on; proxies have no rope and show a straight line
+    const FParkourRope& Rope = OwnerCharacter->GetParkourMovement()->GetRope();
+    Cable->SetWorldLocation(GrappleLocation);
+    Cable->CableLength = Rope.bActive ? Rope.Length : FVector::Dist(GrappleLocation, OwnerCharacter->GetActorLocation());
 }
 
 void UGrapplingHookComponent::ReleaseGrapple()
 {
     if (!bIsGrappling) return;
-    if (GrapplePullAudioComponent && GrapplePullAudioComponent->IsPlaying())
-        GrapplePullAudioComponent->Stop();
     OwnerCharacter->GetCapsuleComponent()->SetCapsuleHalfHeight(OriginalCapsuleHalfHeight);
     bIsGrappling = false;
+    OwnerCharacter->GetParkourMovement()->StopRope();
     MovementComponent->SetMovementMode(MOVE_Walking);
+    UpdateTickSchedule();
+    StopGrappleEffects();
     
-    if (UCableComponent* Cable = OwnerCharacter->GetCable())
-        Cable->SetVisibility(false);
+    if (ShouldBroadcastEvents())
+        MulticastGrappleReleased();
 }
 
 void UGrapplingHookComponent::ClimbAtEnd() //similar to vault mantling
 {
-    if(!ValidateLandingSpace(GrappleLocation))
+    if (bIsProxyGrapple) return;
+    // Landing space was checked once when the path was planned
+    if(!Path.bCanMantle)
     {
         ReleaseGrapple();
         return;
@@ -135,14 +362,9 @@ void UGrapplingHookComponent::ClimbAtEnd() //similar to vault mantling
     
     bIsMantling = true;
     MantleAlpha = 0.0f;
+    UpdateTickSchedule();
     MantleStartLocation = OwnerCharacter->GetActorLocation();
-    
-    const FVector ToGrapplePoint = (GrappleLocation - MantleStartLocation).GetSafeNormal();
-    const float CapsuleRadius = OwnerCharacter->GetCapsuleComponent()->GetScaledCapsuleRadius();
-    
-    // Position the target forward from the grapple point
-    MantleTargetLocation = GrappleLocation + (ToGrapplePoint * (CapsuleRadius + 40.0f));
-    MantleTargetLocation.Z += OriginalCapsuleHalfHeight + 10.0f;
+    MantleTargetLocation = Path.MantleTarget;
     
     if (MovementComponent)
     {
@@ -153,34 +375,33 @@ void UGrapplingHookComponent::ClimbAtEnd() //similar to vault mantling
     ReleaseGrapple();
 }
 
-bool UGrapplingHookComponent::ValidateLandingSpace(const FVector& ObstacleTop) const
+bool UGrapplingHookComponent::ValidateLandingSpace(const FVector& ObstacleTop, const FVector& Direction) const
 {
     const float CapsuleRadius = OwnerCharacter->GetCapsuleComponent()->GetScaledCapsuleRadius();
-    const FVector ForwardVector = OwnerCharacter->GetActorForwardVector();
-    const FVector LandingPos = ObstacleTop + ForwardVector * (CapsuleRadius + 20.0f) + FVector(0, 0, OriginalCapsuleHalfHeight);
+    const FVector LandingPos = ObstacleTop + Direction.GetSafeNormal2D() * (CapsuleRadius + 20.0f) + FVector(0, 0, OriginalCapsuleHalfHeight);
     
     FCollisionQueryParams TraceParams;
     TraceParams.AddIgnoredActor(OwnerCharacter);
-    const bool bHasSpace = !GetWorld()->OverlapAnyTestByChannel(
+    const bool bHasSpace = !PARKOUR_QUERY(Grapple, GetWorld()->OverlapAnyTestByChannel(
         LandingPos, 
         FQuat::Identity, 
         ECC_WorldStatic, 
         FCollisionShape::MakeCapsule(CapsuleRadius * 0.85f, OriginalCapsuleHalfHeight * 0.9f), 
         TraceParams
-    );
+    ));
     
     // DrawDebugCapsule(GetWorld(), LandingPos, CapsuleHalfHeight, CapsuleRadius, FQuat::Identity, bHasSpace ? FColor::Green : FColor::Red, false, 1.5f);
     return bHasSpace;
 }
 
-void UGrapplingHookComponent::UpdateMantle(const float DeltaTime)
+void UGrapplingHookComponent::UpdateMantle()
 {
     if (!bIsMantling) return;
     
-    MantleAlpha += DeltaTime / MantleDuration;
     if (MantleAlpha >= 1.0f)
     {
         bIsMantling = false;
+        UpdateTickSchedule();
         OwnerCharacter->SetActorLocation(MantleTargetLocation);
         if (MovementComponent)
             MovementComponent->SetMovementMode(MOVE_Walking);
@@ -190,22 +411,3 @@ void UGrapplingHookComponent::UpdateMantle(const float DeltaTime)
     const FVector CurrentLocation = FMath::Lerp(MantleStartLocation, MantleTargetLocation, MantleAlpha);
     OwnerCharacter->SetActorLocation(CurrentLocation);
 }
-
-float UGrapplingHookComponent::CalculatePullStrength(const FVector& ToTarget) const
-{
-    float PullStrength = BasePullStrength;
-    
-    if (ToTarget.Z <= 0.0f)
-        PullStrength *= DownwardPullMultiplier;
-    
-    // closer targets get stronger pulls
-    const float DistanceMultiplier = FMath::Clamp(Distance / DistanceScaleReference, MinDistanceMultiplier, MaxDistanceMultiplier);
-    PullStrength *= DistanceMultiplier;
-    
-    return PullStrength;
-}
-
-bool UGrapplingHookComponent::ShouldApplyAntiGravity(const FVector& ToTarget) const
-{
-    return FMath::Abs(ToTarget.Z) < HorizontalGrappleThreshold && Distance > MinHorizontalDistanceForAntiGravity;
-}
@@ -11,20 +11,24 @@ ULandingComponent::ULandingComponent()
 	PrimaryComponentTick.bCanEverTick = false;
 }
 
-void ULandingComponent::HandleFallDetection()
+void ULandingComponent::BeginPlay()
 {
-	if (!OwnerCharacter || !MovementComponent)
-		return;
+	Super::BeginPlay();
+	
+	if (OwnerCharacter)
+		OwnerCharacter->GetMovementEvents().OnMovementModeChanged.AddUObject(this, &ULandingComponent::OnMovementModeChanged);
+}
 
-	if (!bWasFalling && MovementComponent->IsFalling())
+void ULandingComponent::OnMovementModeChanged(const EMovementMode PrevMode, uint8 PrevCustomMode, const EMovementMode NewMode, uint8 NewCustomMode)
+{
+	if (!bWasFalling && NewMode == MOVE_Falling)
 	{
 		// Just started falling
 		bWasFalling = true;
 		LastVelocity = OwnerCharacter->GetVelocity().Length();
 		FallStartZ = OwnerCharacter->GetActorLocation().Z;
 	}
-
-	if (bWasFalling && !MovementComponent->IsFalling())
+	else if (bWasFalling && NewMode != MOVE_Falling)
 	{
 		// Just landed
 		bWasFalling = false;
@@ -35,7 +39,7 @@ void ULandingComponent::HandleFallDetection()
 
 void ULandingComponent::HandleLanding(const float FallDistance) const
 {
-	//LOG_INFO("Fall distance: %f and last velocity: %f", FallDistance, LastVelocity);
+	//LOG_VERBOSE(LogParkourMovement, "Fall distance: %f and last velocity: %f", FallDistance, LastVelocity);
 
 	if (!OwnerCharacter) return;
     
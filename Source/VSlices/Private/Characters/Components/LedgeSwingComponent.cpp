@@ -1,29 +1,112 @@
 #include "Characters/Components/LedgeSwingComponent.h"
 #include "Characters/VSlicesCharacter.h"
 #include "Components/CapsuleComponent.h"
+#include "Subsystems/ParkourAffordanceSubsystem.h"
+
+bool FHangNetEvent::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    uint8 Type = static_cast<uint8>(HangType);
+    Ar.SerializeBits(&Type, 2);
+    HangType = static_cast<EHangType>(Type);
+    
+    bool bNormalSuccess = true;
+    Location.NetSerialize(Ar, Map, bOutSuccess);
+    Normal.NetSerialize(Ar, Map, bNormalSuccess);
+    bOutSuccess &= bNormalSuccess;
+    return bOutSuccess;
+}
 
 ULedgeSwingComponent::ULedgeSwingComponent()
 {
     PrimaryComponentTick.bCanEverTick = true;
+    SetIsReplicatedByDefault(true);
 }
 
-void ULedgeSwingComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void ULedgeSwingComponent::BeginPlay()
 {
-    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+    Super::BeginPlay();
     
+    Affordances = GetWorld()->GetSubsystem<UParkourAffordanceSubsystem>();
+    if (OwnerCharacter)
+    {
+        CapsuleRadius = OwnerCharacter->GetCapsuleComponent()->GetScaledCapsuleRadius();
+        OwnerCharacter->GetMovementEvents().OnMovementModeChanged.AddUObject(this, &ULedgeSwingComponent::OnMovementModeChanged);
+    }
+}
+
+void ULedgeSwingComponent::OnMovementModeChanged(const EMovementMode PrevMode, uint8 PrevCustomMode, const EMovementMode NewMode, uint8 NewCustomMode)
+{
+    // Proxies hang from the server's multicast, never from their own scan
+    const bool bShouldScan = bAutoGrab && NewMode == MOVE_Falling && !IsSimulatedProxy();
+    if (bShouldScan == bScanning)
+        return;
+    
+    bScanning = bShouldScan;
+    bHasScanProbe = false;
+    bPendingScan = false;
+    UpdateTickSchedule();
+}
+
+void ULedgeSwingComponent::ComputeTick(const float DeltaTime, const FParkourRunnerState& State)
+{
+    if (bScanning && !bIsHanging)
+    {
+        // Only on the way down; small moves keep the previous result instead of sweeping again
+        PendingScanProbe = State.Location + FVector(0, 0, ScanHeight) + State.Rotation.Vector().GetSafeNormal2D() * ScanReach;
+        bPendingScan = State.Velocity.Z <= 0.f && (!bHasScanProbe || FVector::DistSquared(PendingScanProbe, LastScanProbe) >= FMath::Square(ScanReuseDistance));
+        return;
+    }
     if (!bIsHanging) return;
     
     if (CurrentHangType == EHangType::Pole)
         UpdateSwing(DeltaTime);
     
-    UpdateHangPosition();
+    PendingHangLocation = CalculateHangPosition();
+}
+
+void ULedgeSwingComponent::ApplyTick(const float DeltaTime)
+{
+    if (bPendingScan)
+    {
+        bPendingScan = false;
+        ScanForLedge();
+    }
+    if (!bIsHanging) return;
+    
+    OwnerCharacter->SetActorLocation(PendingHangLocation);
+}
+
+void ULedgeSwingComponent::ScanForLedge()
+{
+    // Sweeping from the last probe covers everything passed since, however fast the fall
+    const FVector From = bHasScanProbe ? LastScanProbe : OwnerCharacter->GetActorLocation() + FVector(0, 0, ScanHeight);
+    LastScanProbe = PendingScanProbe;
+    bHasScanProbe = true;
+    
+    const float CurrentTime = GetWorld()->GetTimeSeconds();
+    if (CurrentTime < NextAutoGrabTime)
+        return;
+    
+    FCollisionQueryParams TraceParams;
+    TraceParams.AddIgnoredActor(OwnerCharacter);
+    FHitResult Hit;
+    if (!PARKOUR_QUERY(LedgeSwing, GetWorld()->SweepSingleByChannel(Hit, From, PendingScanProbe, FQuat::Identity, ECC_WorldStatic,
+        FCollisionShape::MakeSphere(ScanRadius), TraceParams)))
+        return;
+    
+    // Floors, ceilings and walls off to the side are not ledges in front of us
+    if (FMath::Abs(Hit.ImpactNormal.Z) > 0.3f || (Hit.ImpactNormal | OwnerCharacter->GetActorForwardVector()) > -0.5f)
+        return;
+    
+    if (!TryGrab())
+        NextAutoGrabTime = CurrentTime + FailedGrabRetryDelay;
 }
 
 bool ULedgeSwingComponent::TryGrab()
 {
     if (bIsHanging) 
     {
-        LOG_INFO("Already hanging, cannot grab");
+        LOG_VERBOSE(LogParkourLedge, "Already hanging, cannot grab");
         return false;
     }
     
@@ -33,7 +116,7 @@ bool ULedgeSwingComponent::TryGrab()
     // Try ledge detection first
     if (DetectLedge(GrabLocation, GrabNormal))
     {
-        LOG_INFO("Ledge detected at: %s", *GrabLocation.ToString());
+        LOG_VERBOSE(LogParkourLedge, "Ledge detected at: %s", *GrabLocation.ToString());
         StartHang(GrabLocation, GrabNormal, EHangType::Ledge);
         return true;
     }
@@ -41,12 +124,12 @@ bool ULedgeSwingComponent::TryGrab()
     // Try pole detection
     if (DetectPole(GrabLocation, GrabNormal))
     {
-        LOG_INFO("Pole detected at: %s", *GrabLocation.ToString());
+        LOG_VERBOSE(LogParkourLedge, "Pole detected at: %s", *GrabLocation.ToString());
         StartHang(GrabLocation, GrabNormal, EHangType::Pole);
         return true;
     }
     
-    LOG_INFO("No grabbable surface found");
+    LOG_VERBOSE(LogParkourLedge, "No grabbable surface found");
     return false;
 }
 
@@ -72,6 +155,7 @@ void ULedgeSwingComponent::StartHang(const FVector& Location, const FVector& Nor
     HangLocation = Location;
     HangNormal = Normal;
     CurrentHangType = HangType;
+    UpdateTickSchedule();
     
     // Store initial momentum for poles
     if (HangType == EHangType::Pole)
@@ -88,7 +172,16 @@ void ULedgeSwingComponent::StartHang(const FVector& Location, const FVector& Nor
     
     UpdateHangPosition();
     
-    LOG_INFO("Started hanging on %s at %s", 
+    if (ShouldBroadcastEvents())
+    {
+        FHangNetEvent Event;
+        Event.HangType = HangType;
+        Event.Location = Location;
+        Event.Normal = Normal;
+        MulticastHangStarted(Event);
+    }
+    
+    LOG_RATE_LIMITED(LogParkourLedge, Log, 1, "Started hanging on %s at %s", 
         HangType == EHangType::Pole ? TEXT("Pole") : TEXT("Ledge"),
         *Location.ToString());
 }
@@ -119,6 +212,11 @@ void ULedgeSwingComponent::UpdateHangPosition()
 {
     if (!bIsHanging) return;
     
+    OwnerCharacter->SetActorLocation(CalculateHangPosition());
+}
+
+FVector ULedgeSwingComponent::CalculateHangPosition() const
+{
     FVector TargetLocation = HangLocation;
     
     if (CurrentHangType == EHangType::Pole)
@@ -135,12 +233,11 @@ void ULedgeSwingComponent::UpdateHangPosition()
     else
     {
         // Static hang position for ledges
-        const float CapsuleRadius = OwnerCharacter->GetCapsuleComponent()->GetScaledCapsuleRadius();
         TargetLocation -= HangNormal * (CapsuleRadius + 30.0f);
         TargetLocation.Z -= 70.0f; // Hang below ledge
     }
     
-    OwnerCharacter->SetActorLocation(TargetLocation);
+    return TargetLocation;
 }
 
 void ULedgeSwingComponent::ReleaseHang()
@@ -150,10 +247,38 @@ void ULedgeSwingComponent::ReleaseHang()
     SwingAngle = 0.0f;
     SwingVelocity = 0.0f;
     InitialMomentum = 0.0f;
+    NextAutoGrabTime = GetWorld()->GetTimeSeconds() + RegrabDelay;
+    UpdateTickSchedule();
     
     MovementComponent->SetMovementMode(MOVE_Walking);
     
-    LOG_INFO("Released hang");
+    if (ShouldBroadcastEvents())
+        MulticastHangReleased();
+    
+    LOG_VERBOSE(LogParkourLedge, "Released hang");
+}
+
+void ULedgeSwingComponent::MulticastHangStarted_Implementation(const FHangNetEvent& Event)
+{
+    // Proxy movement comes from replicated movement, like the grapple; the event only sets the hang pose
+    if (!IsSimulatedProxy() || bIsHanging)
+        return;
+    
+    bIsHanging = true;
+    bIsProxyHang = true;
+    CurrentHangType = Event.HangType;
+    HangLocation = Event.Location;
+    HangNormal = Event.Normal;
+}
+
+void ULedgeSwingComponent::MulticastHangReleased_Implementation()
+{
+    if (!bIsProxyHang)
+        return;
+    
+    bIsHanging = false;
+    bIsProxyHang = false;
+    CurrentHangType = EHangType::None;
 }
 
 bool ULedgeSwingComponent::DetectLedge(FVector& OutLocation, FVector& OutNormal)
@@ -165,11 +290,36 @@ bool ULedgeSwingComponent::DetectLedge(FVector& OutLocation, FVector& OutNormal)
     const FVector ForwardStart = PlayerLocation + FVector(0, 0, 50); // Chest height
     const FVector ForwardEnd = ForwardStart + ForwardVector * ForwardReachDistance;
     
+    // Static ledges come from the baked index, traces only run for geometry it does not cover
+    const float MinTopZ = FMath::Max(ForwardStart.Z + UpwardReachDistance - DownwardSearchDistance, PlayerLocation.Z + MinGrabHeight);
+    const EParkourAffordanceQuery Query = Affordances
+        ? Affordances->FindLedge(ForwardStart, ForwardVector, ForwardReachDistance, MinTopZ, ForwardStart.Z + UpwardReachDistance, OutLocation)
+        : EParkourAffordanceQuery::Unknown;
+    
     FCollisionQueryParams TraceParams;
     TraceParams.AddIgnoredActor(OwnerCharacter);
     
+    if (Query == EParkourAffordanceQuery::Found)
+    {
+        // The index only knows static geometry, so anything movable in front of the ledge still blocks the grab
+        FCollisionQueryParams BlockerParams = TraceParams;
+        BlockerParams.MobilityType = EQueryMobilityType::Dynamic;
+        const float LedgeDistance = FMath::Max(FVector::DotProduct(OutLocation - ForwardStart, ForwardVector), 0.f);
+        FHitResult BlockerHit;
+        if (PARKOUR_QUERY(LedgeSwing, GetWorld()->LineTraceSingleByChannel(BlockerHit, ForwardStart, ForwardStart + ForwardVector * LedgeDistance, ECC_WorldStatic, BlockerParams)))
+            return false;
+        
+        OutNormal = FVector::UpVector;
+        return true;
+    }
+    
+    // Only the forward ray was answered by the index, so only it is narrowed to movable geometry
+    FCollisionQueryParams ForwardParams = TraceParams;
+    if (Query == EParkourAffordanceQuery::None)
+        ForwardParams.MobilityType = EQueryMobilityType::Dynamic;
+    
     FHitResult ForwardHit;
-    if (!GetWorld()->LineTraceSingleByChannel(ForwardHit, ForwardStart, ForwardEnd, ECC_WorldStatic, TraceParams))
+    if (!PARKOUR_QUERY(LedgeSwing, GetWorld()->LineTraceSingleByChannel(ForwardHit, ForwardStart, ForwardEnd, ECC_WorldStatic, ForwardParams)))
         return false;
     
     // Downward trace from above hit point to find ledge top
@@ -177,7 +327,7 @@ bool ULedgeSwingComponent::DetectLedge(FVector& OutLocation, FVector& OutNormal)
     const FVector DownEnd = DownStart + FVector::DownVector * DownwardSearchDistance;
     
     FHitResult DownHit;
-    if (!GetWorld()->LineTraceSingleByChannel(DownHit, DownStart, DownEnd, ECC_WorldStatic, TraceParams))
+    if (!PARKOUR_QUERY(LedgeSwing, GetWorld()->LineTraceSingleByChannel(DownHit, DownStart, DownEnd, ECC_WorldStatic, TraceParams)))
         return false;
     
     // Validate it's a proper ledge (horizontal surface)
@@ -200,11 +350,27 @@ bool ULedgeSwingComponent::DetectPole(FVector& OutLocation, FVector& OutNormal)
     const FVector UpStart = PlayerLocation;
     const FVector UpEnd = UpStart + UpVector * UpwardReachDistance;
     
+    const EParkourAffordanceQuery Query = Affordances
+        ? Affordances->FindPole(UpStart, PlayerLocation.Z + MinGrabHeight, UpEnd.Z, OutLocation, OutNormal)
+        : EParkourAffordanceQuery::Unknown;
+    
     FCollisionQueryParams TraceParams;
     TraceParams.AddIgnoredActor(OwnerCharacter);
     
+    if (Query == EParkourAffordanceQuery::Found)
+    {
+        // Movable geometry between the player and the baked pole still blocks the grab
+        FCollisionQueryParams BlockerParams = TraceParams;
+        BlockerParams.MobilityType = EQueryMobilityType::Dynamic;
+        FHitResult BlockerHit;
+        return !PARKOUR_QUERY(LedgeSwing, GetWorld()->LineTraceSingleByChannel(BlockerHit, UpStart, FVector(UpStart.X, UpStart.Y, OutLocation.Z), ECC_WorldStatic, BlockerParams));
+    }
+    
+    if (Query == EParkourAffordanceQuery::None)
+        TraceParams.MobilityType = EQueryMobilityType::Dynamic;
+    
     FHitResult UpHit;
-    if (!GetWorld()->LineTraceSingleByChannel(UpHit, UpStart, UpEnd, ECC_WorldStatic, TraceParams))
+    if (!PARKOUR_QUERY(LedgeSwing, GetWorld()->LineTraceSingleByChannel(UpHit, UpStart, UpEnd, ECC_WorldStatic, TraceParams)))
         return false;
     
     // Check if it's a cylindrical surface (side hit, not top/bottom)
@@ -227,7 +393,7 @@ void ULedgeSwingComponent::SwingJump()
     ReleaseHang();
     OwnerCharacter->LaunchCharacter(JumpVelocity, false, true);
     
-    LOG_INFO("Swing jump with momentum: %f", CurrentMomentum);
+    LOG_VERBOSE(LogParkourLedge, "Swing jump with momentum: %f", CurrentMomentum);
 }
 
 void ULedgeSwingComponent::MantleUp()
@@ -237,7 +403,7 @@ void ULedgeSwingComponent::MantleUp()
     ReleaseHang();
     OwnerCharacter->LaunchCharacter((MantleTarget - OwnerCharacter->GetActorLocation()).GetSafeNormal() * 600, false, true);
     
-    LOG_INFO("Mantling up to: %s", *MantleTarget.ToString());
+    LOG_VERBOSE(LogParkourLedge, "Mantling up to: %s", *MantleTarget.ToString());
 }
 
 float ULedgeSwingComponent::CalculateSwingMomentum() const
@@ -4,22 +4,107 @@
 UParkourComponentBase::UParkourComponentBase()
 {
 	PrimaryComponentTick.bCanEverTick = false;
+	// Ticking components sleep until their state machine becomes active, see UpdateTickSchedule
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 }
 
 void UParkourComponentBase::BeginPlay()
 {
 	Super::BeginPlay();
 
+	ResetQueryBudget();
 	OwnerCharacter = Cast<AVSlicesCharacter>(GetOwner());
 	if (!OwnerCharacter)
 	{
-		LOG_ERROR("Invalid Character!");
+		LOG_ERROR(LogParkour, "Invalid Character!");
 		return;
 	}
 	MovementComponent =  MovementComponent = OwnerCharacter->GetCharacterMovement();
 	if (!MovementComponent)
 	{
-		LOG_ERROR("Invalid MovementComponent");
+		LOG_ERROR(LogParkour, "Invalid MovementComponent");
 		return;
 	}
+	
+	if (OwnerCharacter->UsesParkourSimulation() && GetSimulationChannel() != EParkourSimChannel::None)
+	{
+		Simulation = GetWorld()->GetSubsystem<UParkourSimulationSubsystem>();
+		Simulation->Register(this, GetSimulationChannel());
+		SetComponentTickEnabled(false);
+	}
+	else if (PrimaryComponentTick.bCanEverTick)
+	{
+		// Parkour ticks read the movement result of this frame, so keep them behind it whenever they wake up
+		AddTickPrerequisiteComponent(MovementComponent);
+	}
+	UpdateTickSchedule();
+}
+
+void UParkourComponentBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (Simulation)
+	{
+		Simulation->Unregister(this, GetSimulationChannel());
+		Simulation = nullptr;
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+void UParkourComponentBase::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	SimulateTick(DeltaTime);
+}
+
+void UParkourComponentBase::SimulateTick(const float DeltaTime)
+{
+	if (!OwnerCharacter)
+		return;
+	
+	PARKOUR_TICK_SCOPE(GetSimulationChannel());
+	ComputeTick(DeltaTime, FParkourRunnerState::Capture(OwnerCharacter));
+	ApplyTick(DeltaTime);
+}
+
+void UParkourComponentBase::RecordQuery() const
+{
+	FParkourBenchmarkStats::AddQuery(GetSimulationChannel());
+	
+	if (QueryBudget.Frame != GFrameCounter)
+	{
+		QueryBudget.Frame = GFrameCounter;
+		QueryBudget.FrameQueries = 0;
+	}
+	QueryBudget.FrameQueries++;
+	QueryBudget.Total++;
+	QueryBudget.Peak = FMath::Max(QueryBudget.Peak, QueryBudget.FrameQueries);
+	
+	// Count each frame once, on the query that crosses the limit
+	if (QueryBudgetPerFrame > 0 && QueryBudget.FrameQueries == QueryBudgetPerFrame + 1)
+		QueryBudget.OverBudgetFrames++;
+}
+
+bool UParkourComponentBase::ShouldBroadcastEvents() const
+{
+	return OwnerCharacter && OwnerCharacter->HasAuthority() && GetNetMode() != NM_Standalone;
+}
+
+bool UParkourComponentBase::IsSimulatedProxy() const
+{
+	return OwnerCharacter && OwnerCharacter->GetLocalRole() == ROLE_SimulatedProxy;
+}
+
+void UParkourComponentBase::ResetQueryBudget()
+{
+	QueryBudget = FParkourQueryBudget();
+	if (const UWorld* World = GetWorld())
+		QueryBudget.StartTime = World->GetTimeSeconds();
+}
+
+void UParkourComponentBase::UpdateTickSchedule()
+{
+	if (Simulation)
+		Simulation->SetActive(OwnerCharacter, GetSimulationChannel(), IsSimulationActive());
+	else if (PrimaryComponentTick.bCanEverTick)
+		SetComponentTickEnabled(IsSimulationActive());
 }
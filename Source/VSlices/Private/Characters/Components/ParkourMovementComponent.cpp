@@ -0,0 +1,390 @@
+#include "Characters/Components/ParkourMovementComponent.h"
+#include "Characters/VSlicesCharacter.h"
+#include "Characters/Components/GrapplingHookComponent.h"
+#include "Characters/Components/SlideComponent.h"
+#include "Characters/Components/SprintComponent.h"
+#include "Characters/Components/VaultComponent.h"
+#include "Characters/Components/WallRunComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+
+UParkourMovementComponent::UParkourMovementComponent()
+{
+	SetNetworkMoveDataContainer(ParkourMoveDataContainer);
+}
+
+void UParkourMovementComponent::InitializeComponent()
+{
+	Super::InitializeComponent();
+	
+	ParkourCharacter = Cast<AVSlicesCharacter>(GetOwner());
+}
+
+void UParkourMovementComponent::TickComponent(const float DeltaTime, const ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	// Input has been processed by now, so the move built this tick carries the state it started
+	if (CharacterOwner && CharacterOwner->IsLocallyControlled())
+		ParkourFlags = GatherParkourFlags();
+	
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	UpdateGroundState();
+}
+
+float UParkourMovementComponent::ProbeFloorDistance()
+{
+	if (GroundState.bIsFalling != IsFalling())
+		UpdateGroundState();
+	if (GroundState.bHasFloorDistance || !UpdatedComponent)
+		return GroundState.FloorDistance;
+	
+	FFindFloorResult FloorResult;
+	FindFloor(UpdatedComponent->GetComponentLocation(), FloorResult, true);
+	GroundState.FloorDistance = FloorResult.bBlockingHit ? FloorResult.FloorDist : FParkourGroundState::NoFloorDistance;
+	GroundState.bHasFloorDistance = true;
+	return GroundState.FloorDistance;
+}
+
+float UParkourMovementComponent::GetMaxSpeed() const
+{
+	if (!ParkourCharacter || (MovementMode != MOVE_Walking && MovementMode != MOVE_NavWalking && MovementMode != MOVE_Falling))
+		return Super::GetMaxSpeed();
+	
+	if (HasParkourFlag(EParkourMoveFlags::Slide))
+		return ParkourCharacter->GetSlideComponent()->GetSlideSpeed();
+	if (HasParkourFlag(EParkourMoveFlags::Sprint))
+		return IsCrouching() ? ParkourCharacter->GetMaxCrouchSprintSpeed() : ParkourCharacter->GetMaxSprintSpeed();
+	return Super::GetMaxSpeed();
+}
+
+FNetworkPredictionData_Client* UParkourMovementComponent::GetPredictionData_Client() const
+{
+	if (!ClientPredictionData)
+	{
+		UParkourMovementComponent* MutableThis = const_cast<UParkourMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Parkour(*this);
+	}
+	return ClientPredictionData;
+}
+
+void UParkourMovementComponent::MoveAutonomous(const float ClientTimeStamp, const float DeltaTime, const uint8 CompressedFlags, const FVector& NewAccel)
+{
+	// Only set while the server processes a client move; client replays restore their flags in PrepMoveFor
+	if (const FParkourNetworkMoveData* MoveData = static_cast<const FParkourNetworkMoveData*>(GetCurrentNetworkMoveData()))
+	{
+		ApplyParkourFlags(MoveData->ParkourFlags);
+		// After the flags, so a grapple started by this move reels at the client's rate rather than the attach default
+		if (Rope.bActive)
+			Rope.ReelRate = MoveData->RopeReelRate;
+	}
+	
+	Super::MoveAutonomous(ClientTimeStamp, DeltaTime, CompressedFlags, NewAccel);
+}
+
+void UParkourMovementComponent::PhysCustom(const float DeltaTime, const int32 Iterations)
+{
+	if (CustomMovementMode == static_cast<uint8>(EParkourCustomMode::Grapple))
+		PhysRope(DeltaTime, Iterations);
+	else
+		Super::PhysCustom(DeltaTime, Iterations);
+}
+
+void UParkourMovementComponent::OnMovementModeChanged(const EMovementMode PreviousMovementMode, const uint8 PreviousCustomMode)
+{
+	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+	
+	// Leaving the rope by any route puts the mesh back where it belongs
+	if (PreviousMovementMode == MOVE_Custom && PreviousCustomMode == static_cast<uint8>(EParkourCustomMode::Grapple))
+		UpdateRopeMeshOffset();
+}
+
+void UParkourMovementComponent::StartRope(const FVector& Anchor, const float Length)
+{
+	Rope.Anchor = Anchor;
+	Rope.Length = FMath::Max(Length, MinRopeLength);
+	Rope.ReelRate = 0.f;
+	Rope.StepRemainder = 0.f;
+	Rope.bActive = true;
+	bHasRopeStepStart = false;
+	SetMovementMode(MOVE_Custom, static_cast<uint8>(EParkourCustomMode::Grapple));
+}
+
+void UParkourMovementComponent::StopRope()
+{
+	Rope.bActive = false;
+	Rope.ReelRate = 0.f;
+	Rope.StepRemainder = 0.f;
+	UpdateRopeMeshOffset();
+}
+
+void UParkourMovementComponent::SetRopeReelRate(const float Rate)
+{
+	Rope.ReelRate = FMath::Clamp(FMath::RoundToFloat(Rate), static_cast<float>(MIN_int16), static_cast<float>(MAX_int16));
+}
+
+void UParkourMovementComponent::PhysRope(const float DeltaTime, int32 Iterations)
+{
+	if (DeltaTime < MIN_TICK_TIME)
+		return;
+	if (!Rope.bActive)
+	{
+		SetMovementMode(MOVE_Falling);
+		StartNewPhysics(DeltaTime, Iterations);
+		return;
+	}
+	
+	// Fixed steps from an accumulator: integrate gravity and input, then project back onto the rope sphere and derive
+	// velocity from the corrected position, so a taut rope converts fall speed into swing without adding energy
+	const FVector Gravity(0.f, 0.f, GetGravityZ());
+	const float SubstepTime = RopeSubstepTime;
+	Rope.StepRemainder = FMath::Min(Rope.StepRemainder + DeltaTime, SubstepTime * MaxRopeSteps);
+	while (Rope.StepRemainder >= SubstepTime && IsOnRope() && UpdatedComponent)
+	{
+		Rope.StepRemainder -= SubstepTime;
+		Iterations++;
+		bJustTeleported = false;
+		Rope.Length = FMath::Max(Rope.Length - Rope.ReelRate * SubstepTime, MinRopeLength);
+		
+		const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+		RopeStepStartLocation = OldLocation;
+		bHasRopeStepStart = true;
+		Velocity += (Gravity + Acceleration * RopeAirControl) * SubstepTime;
+		
+		FVector Target = OldLocation + Velocity * SubstepTime;
+		const FVector FromAnchor = Target - Rope.Anchor;
+		if (FromAnchor.SizeSquared() > FMath::Square(Rope.Length))
+			Target = Rope.Anchor + FromAnchor.GetSafeNormal() * Rope.Length;
+		
+		const FVector Delta = Target - OldLocation;
+		FHitResult Hit(1.f);
+		SafeMoveUpdatedComponent(Delta, UpdatedComponent->GetComponentQuat(), true, Hit);
+		if (Hit.IsValidBlockingHit())
+		{
+			HandleImpact(Hit, SubstepTime, Delta);
+			SlideAlongSurface(Delta, 1.f - Hit.Time, Hit.Normal, Hit, true);
+		}
+		
+		if (!bJustTeleported && !HasAnimRootMotion())
+			Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / SubstepTime;
+	}
+	UpdateRopeMeshOffset();
+}
+
+void UParkourMovementComponent::UpdateRopeMeshOffset()
+{
+	// Proxies and listen-server copies of remote pawns keep their mesh for network smoothing
+	USkeletalMeshComponent* Mesh = CharacterOwner ? CharacterOwner->GetMesh() : nullptr;
+	if (!Mesh || !UpdatedComponent || !CharacterOwner->IsLocallyControlled())
+		return;
+	
+	if (!IsOnRope() || !Rope.bActive || !bHasRopeStepStart)
+	{
+		if (bRopeMeshOffset)
+			Mesh->SetRelativeLocation(CharacterOwner->GetBaseTranslationOffset());
+		bRopeMeshOffset = false;
+		return;
+	}
+	
+	// The simulation stays on whole steps; only the drawn position moves back towards the last step's start, one step
+	// behind the simulation at most
+	const float Alpha = FMath::Clamp(Rope.StepRemainder / RopeSubstepTime, 0.f, 1.f);
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+	const FVector Offset = (RopeStepStartLocation - Location) * (1.f - Alpha);
+	Mesh->SetRelativeLocation(CharacterOwner->GetBaseTranslationOffset() + UpdatedComponent->GetComponentQuat().UnrotateVector(Offset));
+	bRopeMeshOffset = true;
+}
+
+bool UParkourMovementComponent::ServerShouldUseAuthoritativePosition(const float ClientTimeStamp, const float DeltaTime, const FVector& Accel,
+	const FVector& ClientLoc, const FVector& RelativeClientLoc, UPrimitiveComponent* ClientMovementBase, const FName ClientBaseBoneName, const uint8 ClientMovementMode)
+{
+	if (IsTrustedScriptedMove(ClientLoc))
+		return true;
+	return Super::ServerShouldUseAuthoritativePosition(ClientTimeStamp, DeltaTime, Accel, ClientLoc, RelativeClientLoc, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+}
+
+bool UParkourMovementComponent::ServerExceedsAllowablePositionError(const float ClientTimeStamp, const float DeltaTime, const FVector& Accel,
+	const FVector& ClientWorldLocation, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, const FName ClientBaseBoneName, const uint8 ClientMovementMode)
+{
+	// Same trust as ServerShouldUseAuthoritativePosition, otherwise the error check would still send corrections;
+	// past the tolerance the regular error check decides
+	if (IsTrustedScriptedMove(ClientWorldLocation))
+		return false;
+	// Only a wall-run the server is running too gets the slack, a client flag alone is not trusted
+	if (ParkourCharacter && HasParkourFlag(EParkourMoveFlags::WallRun) && ParkourCharacter->GetWallRunComponent()->IsWallRunning()
+		&& FVector::DistSquared(ClientWorldLocation, UpdatedComponent->GetComponentLocation()) <= FMath::Square(WallRunPositionTolerance))
+		return false;
+	return Super::ServerExceedsAllowablePositionError(ClientTimeStamp, DeltaTime, Accel, ClientWorldLocation, RelativeClientLocation, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+}
+
+EParkourMoveFlags UParkourMovementComponent::GatherParkourFlags() const
+{
+	if (!ParkourCharacter)
+		return EParkourMoveFlags::None;
+	
+	EParkourMoveFlags Flags = EParkourMoveFlags::None;
+	if (ParkourCharacter->GetIsSprinting()) Flags |= EParkourMoveFlags::Sprint;
+	if (ParkourCharacter->GetIsSliding()) Flags |= EParkourMoveFlags::Slide;
+	if (ParkourCharacter->GetWallRunComponent()->IsWallRunning()) Flags |= EParkourMoveFlags::WallRun;
+	if (ParkourCharacter->GetVaultComponent()->IsVaulting()) Flags |= EParkourMoveFlags::Vault;
+	if (ParkourCharacter->GetGrapplingHookComponent()->GetIsGrappling()) Flags |= EParkourMoveFlags::Grapple;
+	return Flags;
+}
+
+void UParkourMovementComponent::ApplyParkourFlags(const EParkourMoveFlags NewFlags)
+{
+	const EParkourMoveFlags Started = NewFlags & ~ParkourFlags;
+	const EParkourMoveFlags Stopped = ParkourFlags & ~NewFlags;
+	ParkourFlags = NewFlags;
+	if (!ParkourCharacter || (Started | Stopped) == EParkourMoveFlags::None)
+		return;
+	
+	if (EnumHasAnyFlags(Started | Stopped, EParkourMoveFlags::Sprint))
+		ParkourCharacter->GetSprintComponent()->SetSprinting(HasParkourFlag(EParkourMoveFlags::Sprint));
+	
+	if (EnumHasAnyFlags(Started, EParkourMoveFlags::Slide))
+		ParkourCharacter->GetSlideComponent()->StartSlide();
+	else if (EnumHasAnyFlags(Stopped, EParkourMoveFlags::Slide))
+		ParkourCharacter->GetSlideComponent()->StopSlide();
+	
+	// Vault and grapple finish on their own; the server runs its own traces from the same move
+	UVaultComponent* Vault = ParkourCharacter->GetVaultComponent();
+	if (EnumHasAnyFlags(Started, EParkourMoveFlags::Vault) && !Vault->IsVaulting() && !Vault->TryVault(HasParkourFlag(EParkourMoveFlags::Sprint)))
+		LOG_VERBOSE(LogParkourVault, "Server rejected client vault at %s", *ParkourCharacter->GetActorLocation().ToString());
+	
+	UGrapplingHookComponent* Grapple = ParkourCharacter->GetGrapplingHookComponent();
+	if (EnumHasAnyFlags(Started, EParkourMoveFlags::Grapple) && !Grapple->GetIsGrappling() && (!Grapple->TryShoot() || !Grapple->GetIsGrappling()))
+		LOG_VERBOSE(LogParkourGrapple, "Server rejected client grapple at %s", *ParkourCharacter->GetActorLocation().ToString());
+	
+	// Wall-runs start from the server's own hits, but end when the client says so
+	UWallRunComponent* WallRun = ParkourCharacter->GetWallRunComponent();
+	if (EnumHasAnyFlags(Stopped, EParkourMoveFlags::WallRun) && WallRun->IsWallRunning())
+		WallRun->StopWallRun();
+}
+
+bool UParkourMovementComponent::IsScriptedMove() const
+{
+	if (!ParkourCharacter)
+		return false;
+	
+	// The client's flag alone is not enough: a vault or grapple the server rejected gets no position trust
+	return (HasParkourFlag(EParkourMoveFlags::Vault) && ParkourCharacter->GetVaultComponent()->IsVaulting()) ||
+		(HasParkourFlag(EParkourMoveFlags::Grapple) && ParkourCharacter->GetGrapplingHookComponent()->GetIsGrappling());
+}
+
+bool UParkourMovementComponent::IsTrustedScriptedMove(const FVector& ClientWorldLocation) const
+{
+	if (!bTrustClientDuringScriptedMoves || !UpdatedComponent || !IsScriptedMove())
+		return false;
+	
+	// Vaults are checked against the server's own trajectory, grapples against where its rope step left the character
+	FVector ServerLocation = UpdatedComponent->GetComponentLocation();
+	if (HasParkourFlag(EParkourMoveFlags::Vault))
+		ParkourCharacter->GetVaultComponent()->GetTrajectoryLocation(ServerLocation);
+	return FVector::DistSquared(ClientWorldLocation, ServerLocation) <= FMath::Square(ScriptedMovePositionTolerance);
+}
+
+void UParkourMovementComponent::UpdateGroundState()
+{
+	GroundState = FParkourGroundState();
+	GroundState.Frame = GFrameCounter;
+	GroundState.bIsFalling = IsFalling();
+	
+	// CurrentFloor is only kept up to date while walking; airborne floor distance is left to ProbeFloorDistance
+	if (!IsMovingOnGround() || !CurrentFloor.IsWalkableFloor())
+		return;
+	
+	GroundState.FloorHit = CurrentFloor.HitResult;
+	GroundState.FloorDistance = CurrentFloor.FloorDist;
+	GroundState.bHasFloorDistance = true;
+	GroundState.bWalkableFloor = true;
+	
+	const FVector& Normal = CurrentFloor.HitResult.ImpactNormal;
+	GroundState.FloorNormal = Normal;
+	GroundState.FloorDotUp = FMath::Clamp(Normal.Z, 0.f, 1.f);
+	// N x (N x Up) expanded: points down the slope
+	GroundState.SlopeDirection = (Normal * GroundState.FloorDotUp - FVector::UpVector).GetSafeNormal();
+}
+
+#pragma region SAVED MOVES
+
+void UParkourMovementComponent::FSavedMove_Parkour::Clear()
+{
+	Super::Clear();
+	ParkourFlags = EParkourMoveFlags::None;
+	RopeLength = 0.f;
+	RopeReelRate = 0.f;
+	RopeStepRemainder = 0.f;
+}
+
+void UParkourMovementComponent::FSavedMove_Parkour::SetMoveFor(ACharacter* Character, const float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(Character, InDeltaTime, NewAccel, ClientData);
+	const UParkourMovementComponent* Movement = static_cast<UParkourMovementComponent*>(Character->GetCharacterMovement());
+	ParkourFlags = Movement->ParkourFlags;
+	RopeLength = Movement->Rope.Length;
+	RopeReelRate = Movement->Rope.ReelRate;
+	RopeStepRemainder = Movement->Rope.StepRemainder;
+}
+
+void UParkourMovementComponent::FSavedMove_Parkour::PrepMoveFor(ACharacter* Character)
+{
+	Super::PrepMoveFor(Character);
+	UParkourMovementComponent* Movement = static_cast<UParkourMovementComponent*>(Character->GetCharacterMovement());
+	Movement->ParkourFlags = ParkourFlags;
+	if (Movement->Rope.bActive)
+	{
+		Movement->Rope.Length = RopeLength;
+		Movement->Rope.ReelRate = RopeReelRate;
+		Movement->Rope.StepRemainder = RopeStepRemainder;
+	}
+}
+
+bool UParkourMovementComponent::FSavedMove_Parkour::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, const float MaxDelta) const
+{
+	const FSavedMove_Parkour* NewParkourMove = static_cast<const FSavedMove_Parkour*>(NewMove.Get());
+	if (ParkourFlags != NewParkourMove->ParkourFlags || RopeReelRate != NewParkourMove->RopeReelRate)
+		return false;
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+bool UParkourMovementComponent::FSavedMove_Parkour::IsImportantMove(const FSavedMovePtr& LastAckedMove) const
+{
+	// Starting or ending a parkour move must reach the server even if the packet carrying it is lost
+	if (LastAckedMove.IsValid() && ParkourFlags != static_cast<const FSavedMove_Parkour*>(LastAckedMove.Get())->ParkourFlags)
+		return true;
+	return Super::IsImportantMove(LastAckedMove);
+}
+
+FSavedMovePtr UParkourMovementComponent::FNetworkPredictionData_Client_Parkour::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_Parkour());
+}
+
+void UParkourMovementComponent::FParkourNetworkMoveData::ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, const ENetworkMoveType MoveType)
+{
+	FCharacterNetworkMoveData::ClientFillNetworkMoveData(ClientMove, MoveType);
+	const FSavedMove_Parkour& ParkourMove = static_cast<const FSavedMove_Parkour&>(ClientMove);
+	ParkourFlags = ParkourMove.ParkourFlags;
+	RopeReelRate = static_cast<int16>(ParkourMove.RopeReelRate);
+}
+
+bool UParkourMovementComponent::FParkourNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, const ENetworkMoveType MoveType)
+{
+	const bool bSuccess = FCharacterNetworkMoveData::Serialize(CharacterMovement, Ar, PackageMap, MoveType);
+	
+	uint8 Bits = static_cast<uint8>(ParkourFlags);
+	Ar.SerializeBits(&Bits, NumParkourMoveFlags);
+	ParkourFlags = static_cast<EParkourMoveFlags>(Bits);
+	if (EnumHasAnyFlags(ParkourFlags, EParkourMoveFlags::Grapple))
+		Ar << RopeReelRate;
+	else
+		RopeReelRate = 0;
+	return bSuccess && !Ar.IsError();
+}
+
+UParkourMovementComponent::FParkourNetworkMoveDataContainer::FParkourNetworkMoveDataContainer()
+{
+	NewMoveData = &ParkourMoveData[0];
+	PendingMoveData = &ParkourMoveData[1];
+	OldMoveData = &ParkourMoveData[2];
+}
+
+#pragma endregion SAVED MOVES
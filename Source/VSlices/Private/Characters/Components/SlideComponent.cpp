@@ -19,13 +19,15 @@ void USlideComponent::StartSlide()
     SlideElapsed = 0.f;
     ActualSlideDuration = SlideDuration;
 
-    MovementComponent->MaxWalkSpeedCrouched = SlideSpeed;
     OwnerCharacter->LaunchForward();
     OwnerCharacter->Crouch();
 }
 
 void USlideComponent::HandleSlideTick(float DeltaSeconds)
 {
+    if (!bIsSliding)
+        return;
+    
     SlideElapsed += DeltaSeconds;
 
     const float CurrentSpeed = OwnerCharacter->GetVelocity().Size();
@@ -52,6 +54,4 @@ void USlideComponent::StopSlide()
     bIsSliding = false;
     SlideElapsed = 0.f;
     ActualSlideDuration = 0.f;
-
-    MovementComponent->MaxWalkSpeedCrouched = OwnerCharacter->GetMaxCrouchJogSpeed();
 }
\ No newline at end of file
@@ -3,95 +3,103 @@
 #include "Characters/Components/SlopeComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Characters/VSlicesCharacter.h" 
+#include "Characters/Components/ParkourMovementComponent.h"
 #include "Logging/LogMacros.h"
 
 USlopeComponent::USlopeComponent()
 {
 }
 
+void USlopeComponent::BeginPlay()
+{
+    Super::BeginPlay();
+    
+    RefreshSlopeThresholds();
+}
+
+void USlopeComponent::RefreshSlopeThresholds()
+{
+    Thresholds.MinSlopeCos = FMath::Cos(FMath::DegreesToRadians(MinSlopeAngle));
+    Thresholds.SpeedDecreaseCos = FMath::Cos(FMath::DegreesToRadians(MinSlopeSpeedDecreaseAngle));
+    Thresholds.MaxUphillCos = FMath::Cos(FMath::DegreesToRadians(MaxWalkableUphillAngle));
+    Thresholds.MaxDownhillCos = FMath::Cos(FMath::DegreesToRadians(MaxWalkableDownhillAngle));
+    Thresholds.UphillThreshold = UphillThreshold;
+    Thresholds.DownhillThreshold = DownhillThreshold;
+}
+
 void USlopeComponent::ApplySlopeRestrictions(FVector2D& MovementVector)
 {
     // Get fresh slope info
-    const FSlopeInfo CurrentSlopeInfo = GetSlopeInfo();
+    const FSlopeInfo CurrentSlopeInfo = ClassifySlope();
     
     if (!CurrentSlopeInfo.bIsOnSlope) 
     {
-        //LOG_INFO("Not on slope - no restrictions");
+        //LOG_VERBOSE(LogParkourMovement, "Not on slope - no restrictions");
         return;
     }
     
-    //LOG_INFO("On slope: %.1f degrees, Uphill: %s, Downhill: %s", CurrentSlopeInfo.SlopeAngle, CurrentSlopeInfo.bIsUphill ? TEXT("Yes") : TEXT("No"), CurrentSlopeInfo.bIsDownhill ? TEXT("Yes") : TEXT("No"));
+    //LOG_VERBOSE(LogParkourMovement, "On slope: %.1f degrees, Uphill: %s, Downhill: %s", CurrentSlopeInfo.SlopeAngle, CurrentSlopeInfo.bIsUphill ? TEXT("Yes") : TEXT("No"), CurrentSlopeInfo.bIsDownhill ? TEXT("Yes") : TEXT("No"));
     
     const bool bMovingForward = MovementVector.Y > 0.001f;
     const bool bMovingBackward = MovementVector.Y < -0.001f;
     
     if (bMovingForward && CurrentSlopeInfo.bIsUphill)
     {
-        if (CurrentSlopeInfo.SlopeAngle > MaxWalkableUphillAngle)
+        if (CurrentSlopeInfo.FloorDotUp < Thresholds.MaxUphillCos)
         {
-            LOG_WARNING("Blocking uphill movement - too steep: %.1f degrees", CurrentSlopeInfo.SlopeAngle);
+            LOG_VERBOSE(LogParkourMovement, "Blocking uphill movement - too steep: %.1f degrees", FMath::RadiansToDegrees(FMath::Acos(CurrentSlopeInfo.FloorDotUp)));
             MovementVector.Y = 0.0f; 
         }
-        else if (CurrentSlopeInfo.SlopeAngle > MinSlopeSpeedDecreaseAngle)
+        else if (CurrentSlopeInfo.FloorDotUp < Thresholds.SpeedDecreaseCos)
         {
             const float SpeedMultiplier = OwnerCharacter->GetIsSprinting() ? 0.75f : 0.5f;
-            //LOG_INFO("Reducing uphill speed by %.0f%% (was sprinting: %s)", (1.0f - SpeedMultiplier) * 100.0f,OwnerCharacter->GetIsSprinting() ? TEXT("Yes") : TEXT("No"));
+            //LOG_VERBOSE(LogParkourMovement, "Reducing uphill speed by %.0f%% (was sprinting: %s)", (1.0f - SpeedMultiplier) * 100.0f,OwnerCharacter->GetIsSprinting() ? TEXT("Yes") : TEXT("No"));
             MovementVector.Y *= SpeedMultiplier;
         }
     }
     
-    if (bMovingBackward && CurrentSlopeInfo.bIsDownhill && CurrentSlopeInfo.SlopeAngle > MaxWalkableDownhillAngle)
+    if (bMovingBackward && CurrentSlopeInfo.bIsDownhill && CurrentSlopeInfo.FloorDotUp < Thresholds.MaxDownhillCos)
         MovementVector.Y = 0.0f;
 }
 
-FSlopeInfo USlopeComponent::GetSlopeInfo() 
+FSlopeInfo USlopeComponent::GetSlopeInfo() const
 {
-    const float CurrentTime = GetWorld()->GetTimeSeconds();
-    if (CurrentTime - LastSlopeUpdateTime >= SlopeUpdateInterval)
-    {
-        UpdateSlopeInfo();
-        LastSlopeUpdateTime = CurrentTime;
-    }
-    return CachedSlopeInfo;
+    FSlopeInfo SlopeInfo = ClassifySlope();
+    SlopeInfo.SlopeAngle = FMath::RadiansToDegrees(FMath::Acos(SlopeInfo.FloorDotUp));
+    return SlopeInfo;
 }
 
-void USlopeComponent::UpdateSlopeInfo()
+FSlopeInfo USlopeComponent::ClassifySlope() const
 {
-    // Reset slope info
-    CachedSlopeInfo = FSlopeInfo();
-    
-    if (!MovementComponent || !OwnerCharacter)
-    {
-        LOG_WARNING("Missing MovementComponent or OwnerCharacter");
-        return;
-    }
-    
-    const FHitResult& FloorHit = MovementComponent->CurrentFloor.HitResult;
-    if (!FloorHit.IsValidBlockingHit()) 
+    if (!OwnerCharacter)
     {
-       // LOG_INFO("No valid floor hit");
-        return;
+        LOG_WARNING(LogParkourMovement, "Missing OwnerCharacter");
+        return FSlopeInfo();
     }
     
-    const FVector FloorNormal = FloorHit.ImpactNormal;
-    const float FloorDotUp = FVector::DotProduct(FloorNormal, FVector::UpVector);
-    CachedSlopeInfo.SlopeAngle = FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(FloorDotUp, 0.0f, 1.0f)));
-    
-    //LOG_INFO("Floor angle: %.1f degrees", CachedSlopeInfo.SlopeAngle);
+    // Floor normal comes from the movement component's per-frame ground snapshot
+    const FParkourGroundState& Ground = OwnerCharacter->GetGroundState();
+    if (!Ground.bWalkableFloor) 
+        return FSlopeInfo();
     
-    if (CachedSlopeInfo.SlopeAngle <= MinSlopeAngle) 
-    {
-       // LOG_INFO("Slope too shallow (%.1f <= %.1f)", CachedSlopeInfo.SlopeAngle, MinSlopeAngle);
-        return;
-    }
+    return ClassifyNormal(Thresholds, Ground.FloorNormal, OwnerCharacter->GetActorForwardVector());
+}
+
+FSlopeInfo USlopeComponent::ClassifyNormal(const FSlopeThresholds& Thresholds, const FVector& FloorNormal, const FVector& Forward)
+{
+    FSlopeInfo SlopeInfo;
+    SlopeInfo.FloorDotUp = FMath::Clamp(static_cast<float>(FloorNormal.Z), 0.0f, 1.0f);
+    if (SlopeInfo.FloorDotUp >= Thresholds.MinSlopeCos) 
+        return SlopeInfo;
     
-    CachedSlopeInfo.bIsOnSlope = true;
+    SlopeInfo.bIsOnSlope = true;
     
-    const FVector SlopeDirection = FVector::CrossProduct(FloorNormal, 
-        FVector::CrossProduct(FloorNormal, FVector::UpVector)).GetSafeNormal();
-    CachedSlopeInfo.FacingAlignment = FVector::DotProduct(OwnerCharacter->GetActorForwardVector(), SlopeDirection);
+    // Downhill direction is N * (N.Up) - Up, whose length is sqrt(1 - (N.Up)^2) for a unit normal
+    const float AlongDownhill = static_cast<float>(FVector::DotProduct(Forward, FloorNormal)) * SlopeInfo.FloorDotUp - static_cast<float>(Forward.Z);
+    SlopeInfo.FacingAlignment = AlongDownhill * FMath::InvSqrt(FMath::Max(1.0f - FMath::Square(SlopeInfo.FloorDotUp), UE_KINDA_SMALL_NUMBER));
     
     // Determine uphill/downhill
-    CachedSlopeInfo.bIsUphill = CachedSlopeInfo.FacingAlignment < -UphillThreshold;
-    CachedSlopeInfo.bIsDownhill = CachedSlopeInfo.FacingAlignment > DownhillThreshold;
+    SlopeInfo.bIsUphill = SlopeInfo.FacingAlignment < -Thresholds.UphillThreshold;
+    SlopeInfo.bIsDownhill = SlopeInfo.FacingAlignment > Thresholds.DownhillThreshold;
+    return SlopeInfo;
 }
\ No newline at end of file
@@ -19,7 +19,7 @@ void USprintComponent::BeginPlay()
     }
     else
     {
-        LOG_ERROR("Invalid Movement Component");
+        LOG_ERROR(LogParkourMovement, "Invalid Movement Component");
     }
 }
 
@@ -28,11 +28,8 @@ void USprintComponent::StartSprinting()
     if (!bCanSprint || bSprintOnCooldown || !OwnerCharacter || !MovementComponent) 
         return;
     
+    // Speed follows from the sprint flag in UParkourMovementComponent::GetMaxSpeed, so replayed moves get it too
     bIsSprinting = true;
-    if (!OwnerCharacter->bIsCrouched)
-        MovementComponent->MaxWalkSpeed = OwnerCharacter->GetMaxSprintSpeed();
-    else
-        MovementComponent->MaxWalkSpeedCrouched = OwnerCharacter->GetMaxCrouchSprintSpeed();
 }
 
 void USprintComponent::StopSprinting()
@@ -40,17 +37,13 @@ void USprintComponent::StopSprinting()
     if (!OwnerCharacter || !MovementComponent) return;
     
     bIsSprinting = false;
-    if (!OwnerCharacter->bIsCrouched)
-        MovementComponent->MaxWalkSpeed = OwnerCharacter->GetMaxJogSpeed();
-    else 
-        MovementComponent->MaxWalkSpeedCrouched = OwnerCharacter->GetMaxCrouchJogSpeed();
 }
 
 void USprintComponent::SprintCheck(const float ForwardValue, const float RightValue)
 {
     if (!OwnerCharacter || !MovementComponent)
     {
-        LOG_ERROR("SprintComponent: Missing OwnerCharacter or MovementComponent in SprintCheck");
+        LOG_ERROR(LogParkourMovement, "SprintComponent: Missing OwnerCharacter or MovementComponent in SprintCheck");
         return;
     }
     const bool bMovingForward = ForwardValue > 0.001f;
@@ -70,12 +63,12 @@ void USprintComponent::StartSprintCooldown()
     if (SprintCooldownDuration > 0.0f)
     {
         bSprintOnCooldown = true;
-        GetWorld()->GetTimerManager().SetTimer(SprintCooldownTimerHandle,this,&USprintComponent::EndSprintCooldown,SprintCooldownDuration,false);
+        OwnerCharacter->GetCooldowns().Start(EParkourCooldown::Sprint, GetWorld()->GetTimeSeconds(), SprintCooldownDuration);
     }
 }
 
 void USprintComponent::EndSprintCooldown()
 {
     bSprintOnCooldown = false;
-    GetWorld()->GetTimerManager().ClearTimer(SprintCooldownTimerHandle);
+    OwnerCharacter->GetCooldowns().Clear(EParkourCooldown::Sprint);
 }
\ No newline at end of file
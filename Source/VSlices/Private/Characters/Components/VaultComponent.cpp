@@ -1,15 +1,37 @@
 ﻿#include "Characters/Components/VaultComponent.h"
+#include "Animation/AnimInstance.h"
 #include "Characters/VSlicesCharacter.h"
 #include "Components/CapsuleComponent.h"
+#include "Data/VaultRootMotionCurves.h"
 #include "DrawDebugHelpers.h"
+#include "Subsystems/VaultObstacleCacheSubsystem.h"
+
+bool FVaultNetEvent::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    uint8 Type = static_cast<uint8>(VaultType);
+    Ar.SerializeBits(&Type, 2);
+    VaultType = static_cast<EVaultType>(Type);
+    
+    bOutSuccess = !Ar.IsError();
+    return bOutSuccess;
+}
 
 UVaultComponent::UVaultComponent()
 {
+    // Only ticks while vaulting or predicting, and then every frame
     PrimaryComponentTick.bCanEverTick = true;
-	PrimaryComponentTick.TickInterval = 0.1f;
+    // Replicated for its start event only, there are no replicated properties
+    SetIsReplicatedByDefault(true);
     
     TraceParams.AddIgnoredActor(nullptr); 
     ObjectParams.AddObjectTypesToQuery(ECC_WorldStatic);
+    
+    ProbeTraceDelegate.BindUObject(this, &UVaultComponent::OnProbeTraceDone);
+    WallTopTraceDelegate.BindUObject(this, &UVaultComponent::OnWallTopTraceDone);
+    ThicknessTraceDelegate.BindUObject(this, &UVaultComponent::OnThicknessTraceDone);
+    LandingOverlapDelegate.BindUObject(this, &UVaultComponent::OnLandingOverlapDone);
+    
+    RootMotionCurves = TSoftObjectPtr<UVaultRootMotionCurves>(UVaultRootMotionCurves::GetDefaultPath());
 }
 
 void UVaultComponent::BeginPlay()
@@ -17,111 +39,216 @@ void UVaultComponent::BeginPlay()
     Super::BeginPlay();
     
     TraceParams.AddIgnoredActor(OwnerCharacter);
+    DynamicTraceParams = TraceParams;
+    DynamicTraceParams.MobilityType = EQueryMobilityType::Dynamic;
+    if (bUseObstacleCache)
+        ObstacleCache = GetWorld()->GetSubsystem<UVaultObstacleCacheSubsystem>();
+    Affordances = GetWorld()->GetSubsystem<UParkourAffordanceSubsystem>();
     CapsuleRadius = OwnerCharacter->GetCapsuleComponent()->GetScaledCapsuleRadius();
     CapsuleHalfHeight = OwnerCharacter->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+    LoadedCurves = RootMotionCurves.LoadSynchronous();
 }
 
-void UVaultComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UVaultComponent::ComputeTick(const float DeltaTime, const FParkourRunnerState& State)
 {
-    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+    if (!bIsVaulting)
+        return;
+
+    VaultElapsed = FMath::Min(VaultElapsed + DeltaTime, VaultLerpTime);
+    SampleTrajectory(VaultElapsed, PendingMotion);
     
-    if (!bIsVaulting || !OwnerCharacter) 
+    // Without a baked curve, climb height comes from the montage until the final snap
+    const bool bIsClimb = CurrentVaultType == EVaultType::Climb_Short || CurrentVaultType == EVaultType::Climb_Tall;
+    if (bIsClimb && !bTrajectoryFromCurve && VaultElapsed < VaultLerpTime * 0.9f)
+    {
+        PendingMotion.Location.Z = State.Location.Z;
+        PendingMotion.Velocity = FVector::ZeroVector;
+    }
+}
+
+void UVaultComponent::ApplyTick(const float DeltaTime)
+{
+    if (!bIsVaulting)
+    {
+        if (bUseAsyncTraces)
+            StartPrediction();
         return;
+    }
+    
+    // Path is authored by the solver; velocity only feeds animation and exit momentum
+    MovementComponent->Velocity = PendingMotion.Velocity;
+    OwnerCharacter->SetActorLocationAndRotation(PendingMotion.Location, PendingMotion.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+}
 
-    VaultLerpAlpha = FMath::Clamp(VaultLerpAlpha + DeltaTime / VaultLerpTime, 0.f, 1.f);
+#pragma region TRAJECTORY
+
+void UVaultComponent::BuildTrajectory()
+{
+    const bool bIsVault = CurrentVaultType == EVaultType::Vault_Short || CurrentVaultType == EVaultType::Vault_Tall;
+    const int32 NumSteps = FMath::Clamp(FMath::CeilToInt(VaultLerpTime / TrajectorySubstep), 1, MaxTrajectorySteps);
+    TrajectoryStep = VaultLerpTime / NumSteps;
+    
+    // Arrays keep their allocation between vaults
+    TrajectoryPoints.Reset(NumSteps + 1);
+    TrajectoryRotations.Reset(NumSteps + 1);
+    
+    FVector Location = VaultStartLocation;
+    FRotator Rotation = VaultStartRotation;
+    TrajectoryPoints.Add(Location);
+    TrajectoryRotations.Add(Rotation);
+    
+    const FVaultRootMotionCurve* Curve = LoadedCurves ? LoadedCurves->Find(CurrentVaultType, GetVaultMontage(CurrentVaultType)) : nullptr;
+    bTrajectoryFromCurve = Curve != nullptr;
+    
+    for (int32 Step = 1; Step <= NumSteps; Step++)
+    {
+        const float Alpha = static_cast<float>(Step) / NumSteps;
+        if (Curve)
+        {
+            WarpCurveStep(*Curve, Alpha, Location);
+            Rotation = FMath::RInterpTo(Rotation, VaultTargetRotation, TrajectoryStep, bIsVault ? 15.f : 8.f);
+        }
+        else if (bIsVault)
+        {
+            IntegrateVaultStep(Alpha, TrajectoryStep, Location);
+            Rotation = FMath::RInterpTo(Rotation, VaultTargetRotation, TrajectoryStep, 15.f);
+        }
+        else
+        {
+            IntegrateClimbStep(Alpha, Location);
+            Rotation = Alpha >= 0.9f ? VaultTargetRotation : FMath::RInterpTo(Rotation, VaultTargetRotation, TrajectoryStep, 8.f);
+        }
+        TrajectoryPoints.Add(Location);
+        TrajectoryRotations.Add(Rotation);
+    }
     
-    if(CurrentVaultType==EVaultType::Vault_Short || CurrentVaultType==EVaultType::Vault_Tall)
-        UpdateVaultMotion(DeltaTime);
-    else if(CurrentVaultType==EVaultType::Climb_Short || CurrentVaultType==EVaultType::Climb_Tall)
-        UpdateClimbMotion(DeltaTime);
+    // Land exactly on the target however the integration converged
+    TrajectoryPoints.Last() = VaultTargetLocation;
+    TrajectoryRotations.Last() = VaultTargetRotation;
 }
 
-void UVaultComponent::UpdateVaultMotion(const float DeltaTime) const
+void UVaultComponent::WarpCurveStep(const FVaultRootMotionCurve& Curve, const float Alpha, FVector& OutLocation) const
 {
-    const FVector HorizontalPos = FMath::Lerp(VaultStartLocation, VaultTargetLocation, VaultLerpAlpha);
-    const float ArcHeight = FMath::Lerp(VaultStartLocation.Z, VaultTargetLocation.Z, VaultLerpAlpha) + CalculateArcOffset();
-    const FVector TargetLocation(HorizontalPos.X, HorizontalPos.Y, ArcHeight);
+    // Baked curves are normalized, so the montage's shape is stretched from start to target and up to the arc peak
+    const float Forward = Curve.SampleForward(Alpha);
+    const float Up = Curve.SampleUp(Alpha);
+    const FVector StartToTarget = VaultTargetLocation - VaultStartLocation;
+    OutLocation = VaultStartLocation + FVector(StartToTarget.X, StartToTarget.Y, 0.f) * Forward;
     
-    // Final position precision
-    if (VaultLerpAlpha >= 0.9f)
+    if (Curve.bUpToPeak)
     {
-        // Smoothly move to exact final position instead of using velocity
-        const FVector CurrentLocation = OwnerCharacter->GetActorLocation();
-        const FVector FinalLocation = FMath::VInterpTo(CurrentLocation, VaultTargetLocation, DeltaTime, 15.f);
-        OwnerCharacter->SetActorLocation(FinalLocation);
-        MovementComponent->Velocity = FVector::ZeroVector;
+        const float ArcContribution = VaultArcPeak - FMath::Max(VaultStartLocation.Z, VaultTargetLocation.Z);
+        OutLocation.Z = FMath::Lerp(VaultStartLocation.Z, VaultTargetLocation.Z, Forward) + ArcContribution * Up;
     }
     else
+        OutLocation.Z = VaultStartLocation.Z + StartToTarget.Z * Up;
+}
+
+void UVaultComponent::IntegrateVaultStep(const float Alpha, const float Step, FVector& InOutLocation) const
+{
+    // Final position precision: ease onto the target instead of using velocity
+    if (Alpha >= 0.9f)
     {
-        // Use velocity-based movement
-        const FVector CurrentLocation = OwnerCharacter->GetActorLocation();
-        const FVector Direction = (TargetLocation - CurrentLocation).GetSafeNormal();
-        const float Distance = FVector::Dist(CurrentLocation, TargetLocation);
-        const float Speed = Distance / (VaultLerpTime * (1.0f - VaultLerpAlpha + 0.01f));
-        
-        MovementComponent->Velocity = Direction * FMath::Min(Speed, 1000.f);
+        InOutLocation = FMath::VInterpTo(InOutLocation, VaultTargetLocation, Step, 15.f);
+        return;
     }
     
-    // Handle rotation
-    const FRotator NewRotation = FMath::RInterpTo(OwnerCharacter->GetActorRotation(), VaultTargetRotation, DeltaTime, 15.f);
-    OwnerCharacter->SetActorRotation(NewRotation);
+    const FVector HorizontalPos = FMath::Lerp(VaultStartLocation, VaultTargetLocation, Alpha);
+    const float ArcHeight = FMath::Lerp(VaultStartLocation.Z, VaultTargetLocation.Z, Alpha) + CalculateArcOffset(Alpha);
+    const FVector TargetLocation(HorizontalPos.X, HorizontalPos.Y, ArcHeight);
+    
+    const FVector Direction = (TargetLocation - InOutLocation).GetSafeNormal();
+    const float Distance = FVector::Dist(InOutLocation, TargetLocation);
+    const float Speed = Distance / (VaultLerpTime * (1.0f - Alpha + 0.01f));
+    InOutLocation += Direction * FMath::Min(Speed, 1000.f) * Step;
 }
 
-void UVaultComponent::UpdateClimbMotion(const float DeltaTime) const
+void UVaultComponent::IntegrateClimbStep(const float Alpha, FVector& InOutLocation) const
 {
-    MovementComponent->Velocity = FVector::ZeroVector;
-    
-    // Early termination for final position
-    if (VaultLerpAlpha >= 0.9f)
+    if (Alpha >= 0.9f)
     {
-        OwnerCharacter->SetActorLocationAndRotation(VaultTargetLocation, VaultTargetRotation, false, nullptr, ETeleportType::TeleportPhysics);
+        InOutLocation = VaultTargetLocation;
         return;
     }
     
-    // Calculate horizontal movement with accelerated curve near end
-    const float HorizontalLerpAmount = (VaultLerpAlpha > 0.6f) ? FMath::Lerp(0.3f, 0.9f, (VaultLerpAlpha - 0.6f) / 0.3f) : VaultLerpAlpha * 0.3f;
-    
+    // Horizontal movement with accelerated curve near end
+    const float HorizontalLerpAmount = (Alpha > 0.6f) ? FMath::Lerp(0.3f, 0.9f, (Alpha - 0.6f) / 0.3f) : Alpha * 0.3f;
     const FVector StartToTarget = VaultTargetLocation - VaultStartLocation;
-    const FVector HorizontalOffset = FVector(StartToTarget.X, StartToTarget.Y, 0) * HorizontalLerpAmount;
-    const FVector CurrentLocation = OwnerCharacter->GetActorLocation();
-    const FVector NewLocation = VaultStartLocation + HorizontalOffset + FVector(0, 0, CurrentLocation.Z - VaultStartLocation.Z);
+    InOutLocation = VaultStartLocation + FVector(StartToTarget.X, StartToTarget.Y, 0) * HorizontalLerpAmount;
+}
+
+void UVaultComponent::SampleTrajectory(const float Time, FVaultMotionStep& OutMotion) const
+{
+    const int32 LastIndex = TrajectoryPoints.Num() - 1;
+    const float Position = Time / TrajectoryStep;
+    const int32 Index = FMath::Min(FMath::FloorToInt(Position), LastIndex);
+    const int32 Next = FMath::Min(Index + 1, LastIndex);
+    const float Fraction = Position - Index;
+    
+    OutMotion.Location = FMath::Lerp(TrajectoryPoints[Index], TrajectoryPoints[Next], Fraction);
+    OutMotion.Rotation = FMath::Lerp(TrajectoryRotations[Index], TrajectoryRotations[Next], Fraction);
+    OutMotion.Velocity = (TrajectoryPoints[Next] - TrajectoryPoints[Index]) / TrajectoryStep;
+}
+
+bool UVaultComponent::GetTrajectoryLocation(FVector& OutLocation) const
+{
+    if (!bIsVaulting || TrajectoryPoints.Num() == 0)
+        return false;
     
-    const FRotator NewRotation = FMath::RInterpTo(VaultStartRotation, VaultTargetRotation, DeltaTime, 8.f);
-    OwnerCharacter->SetActorLocationAndRotation(NewLocation, NewRotation, false, nullptr, ETeleportType::TeleportPhysics);
+    FVaultMotionStep Motion;
+    SampleTrajectory(VaultElapsed, Motion);
+    OutLocation = Motion.Location;
+    return true;
 }
 
-float UVaultComponent::CalculateArcOffset() const
+float UVaultComponent::CalculateArcOffset(const float Alpha) const
 {
     const float MaxHeight = FMath::Max(VaultStartLocation.Z, VaultTargetLocation.Z);
     const float ArcContribution = VaultArcPeak - MaxHeight;
-    return 4.0f * ArcContribution * VaultLerpAlpha * (1.0f - VaultLerpAlpha);
+    return 4.0f * ArcContribution * Alpha * (1.0f - Alpha);
 }
 
+#pragma endregion TRAJECTORY
+
 bool UVaultComponent::TryVault(const bool bWasSprinting)
 {
     if (!OwnerCharacter || bIsVaulting || !MovementComponent->IsMovingOnGround())
         return false;
         
     FVaultableObstacle Obstacle;
-    return FindVaultableObstacle(Obstacle, bWasSprinting) && ExecuteVault(Obstacle);
+    bool bFound = false;
+    if (!bUseAsyncTraces || !ConsumePrediction(bWasSprinting, bFound, Obstacle))
+        bFound = FindVaultableObstacle(Obstacle, bWasSprinting);
+    
+    const bool bVaulted = bFound && ExecuteVault(Obstacle);
+    bHasFailedAttempt = !bVaulted;
+    if (!bVaulted)
+    {
+        FailedAttempt.Origin = OwnerCharacter->GetActorLocation();
+        FailedAttempt.Forward = OwnerCharacter->GetActorForwardVector();
+        FailedAttempt.bWasSprinting = bWasSprinting;
+    }
+    return bVaulted;
+}
+
+bool UVaultComponent::HasMovedSinceFailedVault(const bool bWasSprinting) const
+{
+    return !bHasFailedAttempt || !IsPredictionCurrent(FailedAttempt, bWasSprinting);
 }
 
 bool UVaultComponent::FindVaultableObstacle(FVaultableObstacle& OutObstacle, const bool bWasSprinting) const
 {
     const FVector PlayerLocation = OwnerCharacter->GetActorLocation();
     const FVector ForwardVector = OwnerCharacter->GetActorForwardVector();
-    const float CurrentTraceDistance = TraceDistance * (bWasSprinting ? 3.0f : 1.0f);
     
     // Find closest obstacle from multi-height traces
     FHitResult BestHit;
     float ClosestDistance = MAX_FLT;
     
-    constexpr int32 NumTraces = 5;
-    for (int32 i = 0; i < NumTraces; i++)
+    for (int32 i = 0; i < NumProbeTraces; i++)
     {
-        const float HeightOffset = FMath::Lerp(MinTraceHeight, MaxTraceHeight, i / static_cast<float>(NumTraces - 1));
-        const FVector Start = PlayerLocation + FVector(0, 0, HeightOffset);
-        const FVector End = Start + ForwardVector * CurrentTraceDistance;
+        FVector Start, End;
+        GetProbeSegment(i, PlayerLocation, ForwardVector, bWasSprinting, Start, End);
         
         FHitResult Hit;
         if (PerformTrace(Hit, Start, End))
@@ -137,33 +264,59 @@ bool UVaultComponent::FindVaultableObstacle(FVaultableObstacle& OutObstacle, con
     return BestHit.bBlockingHit && AnalyzeObstacle(BestHit, OutObstacle);
 }
 
+void UVaultComponent::GetProbeSegment(const int32 Index, const FVector& Origin, const FVector& Forward, const bool bWasSprinting, FVector& OutStart, FVector& OutEnd) const
+{
+    const float CurrentTraceDistance = TraceDistance * (bWasSprinting ? 3.0f : 1.0f);
+    const float HeightOffset = FMath::Lerp(MinTraceHeight, MaxTraceHeight, Index / static_cast<float>(NumProbeTraces - 1));
+    OutStart = Origin + FVector(0, 0, HeightOffset);
+    OutEnd = OutStart + Forward * CurrentTraceDistance;
+}
+
 bool UVaultComponent::AnalyzeObstacle(const FHitResult& Hit, FVaultableObstacle& OutObstacle) const
 {
     const bool bIsWall = Hit.Normal.Z < 0.5f;
-    FVector ObstacleTop;
-    float ObstacleHeight;
     
-    if (bIsWall)
+    // Static geometry results are shared between all runners through the obstacle cache
+    FVaultObstacleCacheEntry Entry;
+    const bool bCached = ObstacleCache && ObstacleCache->FindObstacle(Hit, Entry);
+    bool bStore = !bCached;
+    bool bCacheable = true;
+    if (!bCached)
     {
-        if (!FindWallTop(Hit, ObstacleTop, ObstacleHeight))
-            return false;
+        FVector WallTop = Hit.Location;
+        float WallHeight;
+        bool bDynamicTop = false;
+        Entry.bHasTop = !bIsWall || FindWallTop(Hit, WallTop, WallHeight, bDynamicTop);
+        Entry.TopZ = WallTop.Z;
+        bCacheable = !bDynamicTop;
     }
-    else
+    if (!Entry.bHasTop)
     {
-        ObstacleTop = Hit.Location;
-        ObstacleHeight = ObstacleTop.Z - OwnerCharacter->GetActorLocation().Z;
+        if (ObstacleCache && !bCached) ObstacleCache->StoreObstacle(Hit, Entry);
+        return false;
     }
-    ObstacleHeight = FMath::Abs(ObstacleHeight);
+    
+    const FVector ObstacleTop = GetObstacleTop(Hit, Entry.TopZ);
+    const float ObstacleHeight = FMath::Abs(ObstacleTop.Z - OwnerCharacter->GetActorLocation().Z);
     if (ObstacleHeight < MinHeightForShortVault || ObstacleHeight > MaxHeightForTraverse)
     {
-        LOG_INFO("Obstacle height %.2f outside valid range [%.2f - %.2f]", ObstacleHeight, MinHeightForShortVault, MaxHeightForTraverse);
+        LOG_VERBOSE(LogParkourVault, "Obstacle height %.2f outside valid range [%.2f - %.2f]", ObstacleHeight, MinHeightForShortVault, MaxHeightForTraverse);
+        if (ObstacleCache && !bCached && bCacheable) ObstacleCache->StoreObstacle(Hit, Entry);
         return false;
     }
     
-    LOG_INFO("Obstacle height %.2f ", ObstacleHeight);
-    if (!ValidateLandingSpace(ObstacleTop))
+    // Landing space can be taken by anything, so it is traced on every attempt
+    const bool bHasSpace = ValidateLandingSpace(ObstacleTop);
+    if (bHasSpace && !Entry.bAnalyzed)
+    {
+        Entry.bAnalyzed = true;
+        Entry.bIsThick = bIsWall && IsObstacleThick(Hit, ObstacleTop);
+        bStore = true;
+    }
+    if (ObstacleCache && bStore && bCacheable) ObstacleCache->StoreObstacle(Hit, Entry);
+    if (!bHasSpace)
     {
-        LOG_INFO("Failed landing space validation");
+        LOG_VERBOSE(LogParkourVault, "Failed landing space validation");
         return false;
     }
     
@@ -172,22 +325,36 @@ bool UVaultComponent::AnalyzeObstacle(const FHitResult& Hit, FVaultableObstacle&
         .Normal = Hit.Normal,
         .Height = ObstacleHeight,
         .bIsWall = bIsWall,
-        .bIsThick = bIsWall ? IsObstacleThick(Hit, ObstacleTop) : false
+        .bIsThick = Entry.bIsThick
     };
     
    // DrawDebugSphere(GetWorld(), ObstacleTop, 12.0f, 12, FColor::Purple, false, 2.0f);
-    LOG_INFO("Found %s obstacle - Height: %.2f, Thick: %s", bIsWall ? TEXT("Wall") : TEXT("Platform"), ObstacleHeight, OutObstacle.bIsThick ? TEXT("Yes") : TEXT("No"));
+    LOG_RATE_LIMITED(LogParkourVault, Log, 1, "Found %s obstacle - Height: %.2f, Thick: %s", bIsWall ? TEXT("Wall") : TEXT("Platform"), ObstacleHeight, OutObstacle.bIsThick ? TEXT("Yes") : TEXT("No"));
     
     return true;
 }
 
-bool UVaultComponent::FindWallTop(const FHitResult& WallHit, FVector& OutWallTop, float& OutHeight) const
+bool UVaultComponent::FindWallTop(const FHitResult& WallHit, FVector& OutWallTop, float& OutHeight, bool& bOutDynamicTop) const
 {
-    const FVector Start = WallHit.Location + FVector(0, 0, 200.0f) - WallHit.Normal * 10.0f;
-    const FVector End = Start - FVector(0, 0, 300.0f);
+    FVector Start, End;
+    GetWallTopSegment(WallHit, Start, End);
     
+    float TopZ;
+    bOutDynamicTop = false;
+    const EParkourAffordanceQuery Query = QueryWallTop(WallHit, Start, End, TopZ);
     FHitResult TopHit;
-    if (!PerformTrace(TopHit, Start, End))
+    if (Query == EParkourAffordanceQuery::Found)
+    {
+        // The index only knows static geometry; a movable object resting on the wall top is still traced for
+        OutWallTop = FVector(Start.X, Start.Y, TopZ);
+        bOutDynamicTop = PARKOUR_QUERY(Vault, GetWorld()->LineTraceSingleByObjectType(TopHit, Start, OutWallTop, ObjectParams, DynamicTraceParams));
+        if (bOutDynamicTop)
+            OutWallTop = TopHit.Location;
+        OutHeight = OutWallTop.Z - OwnerCharacter->GetActorLocation().Z;
+        return true;
+    }
+    
+    if (!PARKOUR_QUERY(Vault, GetWorld()->LineTraceSingleByObjectType(TopHit, Start, End, ObjectParams, GetQueryParams(Query))))
         return false;
     
     OutWallTop = TopHit.Location;
@@ -195,23 +362,65 @@ bool UVaultComponent::FindWallTop(const FHitResult& WallHit, FVector& OutWallTop
     return true;
 }
 
+FVector UVaultComponent::GetObstacleTop(const FHitResult& Hit, const float TopZ) const
+{
+    if (Hit.Normal.Z >= 0.5f)
+        return Hit.Location;
+    
+    // Wall top trace is vertical, so only its height needs to be remembered
+    FVector Start, End;
+    GetWallTopSegment(Hit, Start, End);
+    return FVector(Start.X, Start.Y, TopZ);
+}
+
+EParkourAffordanceQuery UVaultComponent::QueryWallTop(const FHitResult& WallHit, const FVector& Start, const FVector& End, float& OutTopZ) const
+{
+    // A movable obstacle in front of a baked wall would otherwise be answered with that wall's top
+    const UPrimitiveComponent* Component = WallHit.GetComponent();
+    if (!Affordances || !Component || Component->Mobility != EComponentMobility::Static)
+        return EParkourAffordanceQuery::Unknown;
+    return Affordances->FindWallTop(Start, End.Z, OutTopZ);
+}
+
+const FCollisionQueryParams& UVaultComponent::GetQueryParams(const EParkourAffordanceQuery Query) const
+{
+    // Narrowed to movable obstacles only where the baked index covers the trace and found nothing static; anything
+    // else, including no index at all, traces all geometry as before
+    return Query == EParkourAffordanceQuery::None ? DynamicTraceParams : TraceParams;
+}
+
+void UVaultComponent::GetWallTopSegment(const FHitResult& WallHit, FVector& OutStart, FVector& OutEnd) const
+{
+    OutStart = WallHit.Location + FVector(0, 0, 200.0f) - WallHit.Normal * 10.0f;
+    OutEnd = OutStart - FVector(0, 0, 300.0f);
+}
+
 bool UVaultComponent::ValidateLandingSpace(const FVector& ObstacleTop) const
 {
-    const FVector ForwardVector = OwnerCharacter->GetActorForwardVector();
-    const FVector LandingPos = ObstacleTop + ForwardVector * (CapsuleRadius + 20.0f) + FVector(0, 0, CapsuleHalfHeight);
+    const FVector LandingPos = GetLandingPosition(ObstacleTop, OwnerCharacter->GetActorForwardVector());
     
-    const bool bHasSpace = !GetWorld()->OverlapAnyTestByChannel(
+    const bool bHasSpace = !PARKOUR_QUERY(Vault, GetWorld()->OverlapAnyTestByChannel(
         LandingPos, 
         FQuat::Identity, 
         ECC_WorldStatic, 
-        FCollisionShape::MakeCapsule(CapsuleRadius * 0.85f, CapsuleHalfHeight * 0.9f), 
+        GetLandingShape(), 
         TraceParams
-    );
+    ));
     
    // DrawDebugCapsule(GetWorld(), LandingPos, CapsuleHalfHeight, CapsuleRadius, FQuat::Identity, bHasSpace ? FColor::Green : FColor::Red, false, 1.5f);
     return bHasSpace;
 }
 
+FVector UVaultComponent::GetLandingPosition(const FVector& ObstacleTop, const FVector& Forward) const
+{
+    return ObstacleTop + Forward * (CapsuleRadius + 20.0f) + FVector(0, 0, CapsuleHalfHeight);
+}
+
+FCollisionShape UVaultComponent::GetLandingShape() const
+{
+    return FCollisionShape::MakeCapsule(CapsuleRadius * 0.85f, CapsuleHalfHeight * 0.9f);
+}
+
 bool UVaultComponent::ExecuteVault(const FVaultableObstacle& Obstacle)
 {
     EVaultType VaultType;
@@ -250,7 +459,7 @@ void UVaultComponent::StartVault(const EVaultType VaultType, const FVector& Targ
     VaultTargetLocation = TargetLocation;
     VaultStartRotation = OwnerCharacter->GetActorRotation();
     VaultTargetRotation = TargetRotation;
-    VaultLerpAlpha = 0.f;
+    VaultElapsed = 0.f;
 
     OwnerCharacter->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
     MovementComponent->SetMovementMode(MOVE_Flying);
@@ -262,14 +471,82 @@ void UVaultComponent::StartVault(const EVaultType VaultType, const FVector& Targ
         VaultLerpTime = OwnerCharacter->PlayAnimMontage(MontageToPlay);
         if (VaultLerpTime <= 0.f) VaultLerpTime = 1.f;
     }
+    
+    BuildTrajectory();
+    UpdateTickSchedule();
+    
+    if (ShouldBroadcastEvents())
+    {
+        FVaultNetEvent Event;
+        Event.VaultType = VaultType;
+        MulticastVaultStarted(Event);
+    }
+    
+    // The baked curve already carries the montage's root motion, extracting it again would move the capsule twice
+    if (UAnimInstance* AnimInstance = OwnerCharacter->GetMesh()->GetAnimInstance(); AnimInstance && bTrajectoryFromCurve)
+    {
+        PreviousRootMotionMode = AnimInstance->RootMotionMode;
+        AnimInstance->SetRootMotionMode(ERootMotionMode::IgnoreRootMotion);
+    }
+}
+
+void UVaultComponent::MulticastVaultStarted_Implementation(const FVaultNetEvent& Event)
+{
+    // Proxy movement comes from replicated movement, like the grapple; the event only plays the montage
+    if (!IsSimulatedProxy())
+        return;
+    UAnimMontage* Montage = GetVaultMontage(Event.VaultType);
+    if (!Montage)
+        return;
+    
+    CurrentVaultType = Event.VaultType;
+    // Montage root motion would move the proxy on top of its replicated position
+    UAnimInstance* AnimInstance = OwnerCharacter->GetMesh()->GetAnimInstance();
+    if (AnimInstance && !bIsProxyVault)
+    {
+        PreviousRootMotionMode = AnimInstance->RootMotionMode;
+        AnimInstance->SetRootMotionMode(ERootMotionMode::IgnoreRootMotion);
+    }
+    bIsProxyVault = true;
+    OwnerCharacter->PlayAnimMontage(Montage);
+    
+    // The finish notify never fires if something else cuts the montage short
+    if (AnimInstance)
+    {
+        FOnMontageEnded EndDelegate;
+        EndDelegate.BindUObject(this, &UVaultComponent::OnProxyMontageEnded);
+        AnimInstance->Montage_SetEndDelegate(EndDelegate, Montage);
+    }
+}
+
+void UVaultComponent::OnProxyMontageEnded(UAnimMontage* Montage, bool bInterrupted)
+{
+    // A newer vault taking over also ends this montage; the proxy state then belongs to that vault
+    const UAnimInstance* AnimInstance = OwnerCharacter->GetMesh()->GetAnimInstance();
+    if (bIsProxyVault && !(AnimInstance && AnimInstance->Montage_IsPlaying(GetVaultMontage(CurrentVaultType))))
+        FinishVault();
 }
 
 void UVaultComponent::FinishVault()
 {
     if (!OwnerCharacter) return;
     
+    if (bIsProxyVault)
+    {
+        bIsProxyVault = false;
+        if (UAnimInstance* AnimInstance = OwnerCharacter->GetMesh()->GetAnimInstance())
+            AnimInstance->SetRootMotionMode(PreviousRootMotionMode);
+        return;
+    }
+    if (!bIsVaulting) return;
+    
     bIsVaulting = false;
-    VaultLerpAlpha = 0.f;
+    VaultElapsed = 0.f;
+    UpdateTickSchedule();
+    
+    if (UAnimInstance* AnimInstance = OwnerCharacter->GetMesh()->GetAnimInstance(); AnimInstance && bTrajectoryFromCurve)
+        AnimInstance->SetRootMotionMode(PreviousRootMotionMode);
+    bTrajectoryFromCurve = false;
     
     OwnerCharacter->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
     MovementComponent->SetMovementMode(MOVE_Walking);
@@ -277,8 +554,8 @@ void UVaultComponent::FinishVault()
 
 bool UVaultComponent::IsObstacleThick(const FHitResult& Hit, const FVector& WallTop) const
 {
-    const FVector Start = WallTop + FVector(0, 0, 50.0f) - Hit.Normal * ThicknessForClimb;
-    const FVector End = Start - FVector(0, 0, 100.0f);
+    FVector Start, End;
+    GetThicknessSegment(Hit, WallTop, Start, End);
     
     FHitResult ThicknessHit;
     const bool bIsThick = PerformTrace(ThicknessHit, Start, End);
@@ -289,6 +566,12 @@ bool UVaultComponent::IsObstacleThick(const FHitResult& Hit, const FVector& Wall
     return bIsThick;
 }
 
+void UVaultComponent::GetThicknessSegment(const FHitResult& Hit, const FVector& WallTop, FVector& OutStart, FVector& OutEnd) const
+{
+    OutStart = WallTop + FVector(0, 0, 50.0f) - Hit.Normal * ThicknessForClimb;
+    OutEnd = OutStart - FVector(0, 0, 100.0f);
+}
+
 UAnimMontage* UVaultComponent::GetVaultMontage(const EVaultType VaultType) const
 {
     switch (VaultType)
@@ -309,5 +592,263 @@ void UVaultComponent::DrawTraceDebug(const FVector& Start, const FVector& End, c
 
 bool UVaultComponent::PerformTrace(FHitResult& OutHit, const FVector& Start, const FVector& End) const
 {
-    return GetWorld()->LineTraceSingleByObjectType(OutHit, Start, End, ObjectParams, TraceParams);
-}
\ No newline at end of file
+    return PARKOUR_QUERY(Vault, GetWorld()->LineTraceSingleByObjectType(OutHit, Start, End, ObjectParams, TraceParams));
+}
+
+#pragma region ASYNC PREDICTION
+
+void UVaultComponent::StartPrediction()
+{
+    // Only one pipeline in flight
+    if (Prediction.Stage != EVaultPredictionStage::Idle)
+        return;
+    if (!MovementComponent->IsMovingOnGround())
+    {
+        LastPrediction.Stage = EVaultPredictionStage::Idle;
+        return;
+    }
+    
+    // Keep a finished result while it still describes what is in front of the runner
+    const bool bHasResult = LastPrediction.Stage == EVaultPredictionStage::Ready;
+    if (bHasResult && IsPredictionCurrent(LastPrediction, OwnerCharacter->GetIsSprinting()) &&
+        GetWorld()->GetTimeSeconds() - LastPrediction.CompletedTime < PredictionMaxAge)
+        return;
+    
+    // Standing still with nothing ahead, there is nothing new to find
+    const bool bObstacleAhead = bHasResult && LastPrediction.BestHit.bBlockingHit;
+    if (!bObstacleAhead && MovementComponent->Velocity.SizeSquared2D() < FMath::Square(PredictionMinSpeed))
+        return;
+    
+    Prediction = FVaultPrediction();
+    Prediction.Stage = EVaultPredictionStage::Probing;
+    Prediction.Origin = OwnerCharacter->GetActorLocation();
+    Prediction.Forward = OwnerCharacter->GetActorForwardVector();
+    Prediction.bWasSprinting = OwnerCharacter->GetIsSprinting();
+    Prediction.PendingQueries = NumProbeTraces;
+    
+    for (int32 i = 0; i < NumProbeTraces; i++)
+    {
+        FVector Start, End;
+        GetProbeSegment(i, Prediction.Origin, Prediction.Forward, Prediction.bWasSprinting, Start, End);
+        ProbeHandles[i] = PARKOUR_QUERY(Vault, GetWorld()->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Start, End, ObjectParams, TraceParams, &ProbeTraceDelegate));
+    }
+}
+
+void UVaultComponent::OnProbeTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+    if (Prediction.Stage != EVaultPredictionStage::Probing)
+        return;
+    
+    bool bCurrent = false;
+    for (const FTraceHandle& ProbeHandle : ProbeHandles)
+        bCurrent |= ProbeHandle == Handle;
+    if (!bCurrent)
+        return;
+    
+    if (Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit)
+    {
+        const FHitResult& Hit = Datum.OutHits[0];
+        if (const float Distance = FVector::DistSquared(Prediction.Origin, Hit.Location); Distance < Prediction.ClosestDistance)
+        {
+            Prediction.ClosestDistance = Distance;
+            Prediction.BestHit = Hit;
+        }
+    }
+    
+    if (--Prediction.PendingQueries > 0)
+        return;
+    
+    if (!Prediction.BestHit.bBlockingHit)
+    {
+        FinishPrediction(false);
+        return;
+    }
+    
+    FVaultObstacleCacheEntry Entry;
+    if (ObstacleCache && ObstacleCache->FindObstacle(Prediction.BestHit, Entry))
+    {
+        Prediction.bCachedAnalysis = Entry.bAnalyzed;
+        Prediction.bIsThick = Entry.bIsThick;
+        if (!Entry.bHasTop)
+        {
+            FinishPrediction(false);
+            return;
+        }
+        Prediction.ObstacleTop = GetObstacleTop(Prediction.BestHit, Entry.TopZ);
+        IssuePredictionValidation();
+        return;
+    }
+    
+    if (Prediction.BestHit.Normal.Z < 0.5f)
+    {
+        FVector Start, End;
+        GetWallTopSegment(Prediction.BestHit, Start, End);
+        
+        float TopZ;
+        const EParkourAffordanceQuery Query = QueryWallTop(Prediction.BestHit, Start, End, TopZ);
+        Prediction.Stage = EVaultPredictionStage::WallTop;
+        if (Query == EParkourAffordanceQuery::Found)
+        {
+            // Baked top known; the trace down to it only looks for movable objects resting on it
+            Prediction.ObstacleTop = FVector(Start.X, Start.Y, TopZ);
+            Prediction.bBakedTop = true;
+            WallTopHandle = PARKOUR_QUERY(Vault, GetWorld()->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Start, Prediction.ObstacleTop, ObjectParams, DynamicTraceParams, &WallTopTraceDelegate));
+            return;
+        }
+        
+        WallTopHandle = PARKOUR_QUERY(Vault, GetWorld()->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Start, End, ObjectParams, GetQueryParams(Query), &WallTopTraceDelegate));
+        return;
+    }
+    
+    Prediction.ObstacleTop = Prediction.BestHit.Location;
+    IssuePredictionValidation();
+}
+
+void UVaultComponent::OnWallTopTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+    if (Prediction.Stage != EVaultPredictionStage::WallTop || Handle != WallTopHandle)
+        return;
+    
+    if (Datum.OutHits.Num() == 0 || !Datum.OutHits[0].bBlockingHit)
+    {
+        if (Prediction.bBakedTop)
+        {
+            IssuePredictionValidation();
+            return;
+        }
+        StorePrediction(false);
+        FinishPrediction(false);
+        return;
+    }
+    
+    Prediction.ObstacleTop = Datum.OutHits[0].Location;
+    Prediction.bDynamicTop = Prediction.bBakedTop;
+    IssuePredictionValidation();
+}
+
+void UVaultComponent::IssuePredictionValidation()
+{
+    Prediction.ObstacleHeight = FMath::Abs(Prediction.ObstacleTop.Z - Prediction.Origin.Z);
+    if (Prediction.ObstacleHeight < MinHeightForShortVault || Prediction.ObstacleHeight > MaxHeightForTraverse)
+    {
+        if (!Prediction.bCachedAnalysis)
+            StorePrediction(true);
+        FinishPrediction(false);
+        return;
+    }
+    // Thickness and landing space only depend on the obstacle top, so they go out together. Landing space is never
+    // cached, thickness only when the cache has not seen this obstacle yet
+    Prediction.Stage = EVaultPredictionStage::Validating;
+    Prediction.PendingQueries = 1;
+    LandingHandle = PARKOUR_QUERY(Vault, GetWorld()->AsyncOverlapByChannel(
+        GetLandingPosition(Prediction.ObstacleTop, Prediction.Forward),
+        FQuat::Identity,
+        ECC_WorldStatic,
+        GetLandingShape(),
+        TraceParams,
+        FCollisionResponseParams::DefaultResponseParam,
+        &LandingOverlapDelegate
+    ));
+    
+    if (!Prediction.bCachedAnalysis && Prediction.BestHit.Normal.Z < 0.5f)
+    {
+        FVector Start, End;
+        GetThicknessSegment(Prediction.BestHit, Prediction.ObstacleTop, Start, End);
+        Prediction.PendingQueries++;
+        ThicknessHandle = PARKOUR_QUERY(Vault, GetWorld()->AsyncLineTraceByObjectType(EAsyncTraceType::Test, Start, End, ObjectParams, TraceParams, &ThicknessTraceDelegate));
+    }
+}
+
+void UVaultComponent::OnThicknessTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+    if (Prediction.Stage != EVaultPredictionStage::Validating || Handle != ThicknessHandle)
+        return;
+    
+    Prediction.bIsThick = Datum.OutHits.Num() > 0;
+    if (--Prediction.PendingQueries == 0)
+        FinishValidation();
+}
+
+void UVaultComponent::OnLandingOverlapDone(const FTraceHandle& Handle, FOverlapDatum& Datum)
+{
+    if (Prediction.Stage != EVaultPredictionStage::Validating || Handle != LandingHandle)
+        return;
+    
+    Prediction.bHasSpace = Datum.OutOverlaps.Num() == 0;
+    if (--Prediction.PendingQueries == 0)
+        FinishValidation();
+}
+
+void UVaultComponent::FinishValidation()
+{
+    if (!Prediction.bCachedAnalysis)
+    {
+        Prediction.bCachedAnalysis = true;
+        StorePrediction(true);
+    }
+    FinishPrediction(Prediction.bHasSpace);
+}
+
+void UVaultComponent::StorePrediction(const bool bHasTop) const
+{
+    if (!ObstacleCache || Prediction.bDynamicTop)
+        return;
+    
+    FVaultObstacleCacheEntry Entry;
+    Entry.bHasTop = bHasTop;
+    Entry.TopZ = Prediction.ObstacleTop.Z;
+    Entry.bAnalyzed = Prediction.bCachedAnalysis;
+    Entry.bIsThick = Prediction.bIsThick;
+    ObstacleCache->StoreObstacle(Prediction.BestHit, Entry);
+}
+
+void UVaultComponent::FinishPrediction(const bool bFound)
+{
+    Prediction.Stage = EVaultPredictionStage::Ready;
+    Prediction.bFound = bFound;
+    Prediction.CompletedTime = GetWorld()->GetTimeSeconds();
+    LastPrediction = Prediction;
+    Prediction.Stage = EVaultPredictionStage::Idle;
+}
+
+bool UVaultComponent::IsPredictionCurrent(const FVaultPrediction& Result, const bool bWasSprinting) const
+{
+    // Stale if the runner moved or turned since the probes went out
+    return Result.bWasSprinting == bWasSprinting &&
+        FVector::DistSquared(Result.Origin, OwnerCharacter->GetActorLocation()) <= FMath::Square(PredictionLocationTolerance) &&
+        FVector::DotProduct(Result.Forward, OwnerCharacter->GetActorForwardVector()) >= PredictionMinForwardDot;
+}
+
+bool UVaultComponent::ConsumePrediction(const bool bWasSprinting, bool& bOutFound, FVaultableObstacle& OutObstacle)
+{
+    // Too old to trust: something may have moved in front since, and a slow runner does not probe again by itself,
+    // so the caller falls back to the synchronous search
+    if (LastPrediction.Stage != EVaultPredictionStage::Ready || !IsPredictionCurrent(LastPrediction, bWasSprinting) ||
+        GetWorld()->GetTimeSeconds() - LastPrediction.CompletedTime >= PredictionMaxAge)
+        return false;
+    
+    LastPrediction.Stage = EVaultPredictionStage::Idle;
+    bOutFound = LastPrediction.bFound;
+    if (!bOutFound)
+        return true;
+    
+    // The probes went out from Origin; the runner may have stepped up or down since
+    const float Height = FMath::Abs(LastPrediction.ObstacleTop.Z - OwnerCharacter->GetActorLocation().Z);
+    if (Height < MinHeightForShortVault || Height > MaxHeightForTraverse)
+    {
+        bOutFound = false;
+        return true;
+    }
+    
+    const bool bIsWall = LastPrediction.BestHit.Normal.Z < 0.5f;
+    OutObstacle = FVaultableObstacle{
+        .TopLocation = LastPrediction.ObstacleTop,
+        .Normal = LastPrediction.BestHit.Normal,
+        .Height = Height,
+        .bIsWall = bIsWall,
+        .bIsThick = bIsWall && LastPrediction.bIsThick
+    };
+    return true;
+}
+
+#pragma endregion ASYNC PREDICTION
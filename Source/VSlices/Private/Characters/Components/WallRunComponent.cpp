@@ -4,6 +4,7 @@
 #include "Characters/Components/WallRunComponent.h"
 #include "Characters/VSlicesCharacter.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Characters/Components/ParkourMovementComponent.h"
 
 UWallRunComponent::UWallRunComponent()
 {
@@ -15,32 +16,49 @@ void UWallRunComponent::BeginPlay()
 {
 	Super::BeginPlay();
 	DefaultGravityScale = MovementComponent->GravityScale;
+	OwnerCharacter->GetMovementEvents().OnLanded.AddUObject(this, &UWallRunComponent::OnOwnerLanded);
 }
 
-void UWallRunComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UWallRunComponent::OnOwnerLanded(const FHitResult& Hit)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	ResetWallRun();
+	StopWallRun();
+}
 
+void UWallRunComponent::ComputeTick(const float DeltaTime, const FParkourRunnerState& State)
+{
 	if (bCameraTilt)
 		UpdateCameraTilt(DeltaTime);
 	
-	if (!bIsWallRunning || !IsValid(OwnerCharacter)) return;
+	if (!bIsWallRunning) return;
 	
-	const FVector CurrentVelocity = OwnerCharacter->GetVelocity();
-	const float HorizontalSpeed = FVector2D(CurrentVelocity.X, CurrentVelocity.Y).Size();
-	if (HorizontalSpeed < MinVelocity)
+	const float HorizontalSpeed = FVector2D(State.Velocity.X, State.Velocity.Y).Size();
+	bPendingStop = HorizontalSpeed < MinVelocity;
+}
+
+void UWallRunComponent::ApplyTick(const float DeltaTime)
+{
+	if (bPendingStop && IsValid(OwnerCharacter))
 		StopWallRun();
+	bPendingStop = false;
+	
+	// Tilt may have settled during compute
+	if (!IsSimulationActive())
+		UpdateTickSchedule();
 }
 
 void UWallRunComponent::TryWallRun(const FHitResult& Hit)
 {
+	if (!PassesPrefilter(Hit))
+		return;
+	
 	const float CurrentTime = GetWorld()->GetTimeSeconds();
 	if (CurrentTime - LastWallRunAttempt < WallRunAttemptCooldown)
 		return;
         
 	LastWallRunAttempt = CurrentTime;
     
-	if(CheckForWall(Hit))
+	if(IsRunnableSurface(Hit.GetActor()) && CheckForWall(Hit))
 	{
 		if(LastWallActor==Hit.GetActor()) return;
 		LastWallActor = Hit.GetActor();
@@ -50,31 +68,46 @@ void UWallRunComponent::TryWallRun(const FHitResult& Hit)
 		StopWallRun();
 }
 
-bool UWallRunComponent::CheckForWall(const FHitResult& Hit) 
+bool UWallRunComponent::PassesPrefilter(const FHitResult& Hit) const
 {
-	if(!MovementComponent->IsFalling()) return false;
+	if (MovementComponent->MovementMode != MOVE_Falling || FMath::Abs(Hit.ImpactNormal.Z) > MaxWallNormalZ)
+		return false;
 	
-	const FVector CurrentVelocity = OwnerCharacter->GetVelocity();
-	const float HorizontalSpeed = FVector2D(CurrentVelocity.X, CurrentVelocity.Y).Size();
-	if (HorizontalSpeed < MinVelocity)
+	const FVector& CurrentVelocity = MovementComponent->Velocity;
+	if (FVector2D(CurrentVelocity.X, CurrentVelocity.Y).SizeSquared() < FMath::Square(MinVelocity))
 		return false;
+	
+	return FMath::Abs(FVector::DotProduct(Hit.Normal, OwnerCharacter->GetActorRightVector())) >= MinWallAngleDot;
+}
 
-	float WallDot = FVector::DotProduct(Hit.Normal, OwnerCharacter->GetActorRightVector());
-	Direction = (WallDot > 0) ? EWallRunDir::Right : EWallRunDir::Left;
-	WallDot = FMath::Abs(WallDot);
-	if (WallDot < MinWallAngleDot)
+bool UWallRunComponent::IsRunnableSurface(const AActor* WallActor) const
+{
+	if (!WallActor)
 		return false;
+	
+	// Anything that moves under physics or is another pawn would drag the run along with it. Checked on every hit:
+	// tags and physics can be switched at runtime, and each test is cheaper than a cache lookup
+	const UPrimitiveComponent* Root = Cast<UPrimitiveComponent>(WallActor->GetRootComponent());
+	return !WallActor->IsA<APawn>() && !WallActor->ActorHasTag(NoWallRunTag) && !(Root && Root->IsSimulatingPhysics());
+}
 
-	FFindFloorResult FloorResult;
-	MovementComponent->FindFloor(OwnerCharacter->GetActorLocation(), FloorResult, true);
-    
-	return FloorResult.FloorDist > MinWallHeight;
+bool UWallRunComponent::CheckForWall(const FHitResult& Hit) 
+{
+	Direction = FVector::DotProduct(Hit.Normal, OwnerCharacter->GetActorRightVector()) > 0 ? EWallRunDir::Right : EWallRunDir::Left;
+
+	// Shares the movement component's floor probe, so repeated wall hits in one frame sweep once. Only an airborne
+	// snapshot's distance still holds; one taken while walking is stale once the character has jumped off
+	UParkourMovementComponent* ParkourMovement = OwnerCharacter->GetParkourMovement();
+	const FParkourGroundState& Ground = ParkourMovement->GetGroundState();
+	const bool bReuseDistance = Ground.bIsFalling && Ground.bHasFloorDistance;
+	const float FloorDistance = bReuseDistance ? Ground.FloorDistance : PARKOUR_QUERY(WallRun, ParkourMovement->ProbeFloorDistance());
+	return FloorDistance > MinWallHeight;
 }
 
 void UWallRunComponent::StartWallRun(const FVector& WallNormal)
 {
 	if(!MovementComponent->IsFalling() || bIsWallRunning) return;
-	//LOG_INFO("start Wall run");
+	//LOG_VERBOSE(LogParkourWallRun, "start Wall run");
 
 	bIsWallRunning = true;
 	bCameraTilt = true;
@@ -84,18 +117,21 @@ void UWallRunComponent::StartWallRun(const FVector& WallNormal)
 	MovementComponent->SetPlaneConstraintEnabled(true);
 	MovementComponent->SetPlaneConstraintNormal(WallNormal);
 	MovementComponent->GravityScale = WallRunGravityScale;
+	UpdateTickSchedule();
 	
-	GetWorld()->GetTimerManager().SetTimer(WallRunTimerHandle, this, &UWallRunComponent::StopWallRun, WallRunTimer, false);
+	// The character stops the wall-run when this expires
+	OwnerCharacter->GetCooldowns().Start(EParkourCooldown::WallRun, GetWorld()->GetTimeSeconds(), WallRunTimer);
 }
 
 void UWallRunComponent::StopWallRun()
 {
-	//LOG_INFO("Stop Wall run");
-	GetWorld()->GetTimerManager().ClearTimer(WallRunTimerHandle);
+	//LOG_VERBOSE(LogParkourWallRun, "Stop Wall run");
+	OwnerCharacter->GetCooldowns().Clear(EParkourCooldown::WallRun);
 	MovementComponent->SetPlaneConstraintEnabled(false);
 	MovementComponent->GravityScale = DefaultGravityScale;
 	bIsWallRunning = false;
 	bCameraTilt = true;
+	UpdateTickSchedule();
 }
 
 void UWallRunComponent::Jump()
@@ -116,15 +152,17 @@ void UWallRunComponent::Jump()
 	DirLaunchVelocity.Z += JumpHeightBoost;
 	OwnerCharacter->LaunchCharacter(DirLaunchVelocity, false, true);
 	bIsWallRunning = false;
+	UpdateTickSchedule();
 }
 
 void UWallRunComponent::ResetWallRun()
 {
-	GetWorld()->GetTimerManager().ClearTimer(WallRunTimerHandle);
+	OwnerCharacter->GetCooldowns().Clear(EParkourCooldown::WallRun);
 	bIsWallRunning = false;
 	Direction = EWallRunDir::None;
 	bCameraTilt = false;
 	LastWallActor=nullptr;
+	UpdateTickSchedule();
 }
 
 void UWallRunComponent::UpdateCameraTilt(const float DeltaTime)
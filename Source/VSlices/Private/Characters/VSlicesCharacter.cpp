@@ -6,6 +6,7 @@
 #include "GameFramework/Controller.h"
 #include "InputActionValue.h"
 #include "Characters/Components/LandingComponent.h"
+#include "Characters/Components/ParkourMovementComponent.h"
 #include "Characters/Components/GrapplingHookComponent.h"
 #include "Characters/Components/SprintComponent.h"
 #include "Characters/Components/SlideComponent.h"
@@ -15,12 +16,11 @@
 #include "CableComponent.h" 
 #include "Characters/Components/LedgeSwingComponent.h"
 
-DEFINE_LOG_CATEGORY(LogTemplateCharacter);
-
 //////////////////////////////////////////////////////////////////////////
 // AVSlicesCharacter
 
-AVSlicesCharacter::AVSlicesCharacter()
+AVSlicesCharacter::AVSlicesCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UParkourMovementComponent>(CharacterMovementComponentName))
 {
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
 	
@@ -56,6 +56,9 @@ void AVSlicesCharacter::Tick(float DeltaSeconds)
 {
 	Super::Tick(DeltaSeconds);
 	
+	if (const uint8 Expired = Cooldowns.Expire(GetWorld()->GetTimeSeconds()))
+		OnCooldownsExpired(Expired);
+	
 	if (bInCoyoteTime)
 	{
 		CoyoteTimeRemaining -= DeltaSeconds;
@@ -67,9 +70,6 @@ void AVSlicesCharacter::Tick(float DeltaSeconds)
 	}
 	if (SlideComponent)
 		SlideComponent->HandleSlideTick(DeltaSeconds);
-	
-	if (LandingComponent)
-		LandingComponent->HandleFallDetection();
 }
 
 void AVSlicesCharacter::Move(const FInputActionValue& Value)
@@ -137,9 +137,9 @@ void AVSlicesCharacter::StopSprinting() const
 	if(SprintComponent) SprintComponent->StopSprinting();
 }
 
-void AVSlicesCharacter::ShootGrapplingHook() const
+bool AVSlicesCharacter::ShootGrapplingHook() const
 {
-	GrapplingHookComponent->TryShoot();
+	return GrapplingHookComponent->TryShoot();
 }
 
 void AVSlicesCharacter::ToggleCrouch()
@@ -148,6 +148,14 @@ void AVSlicesCharacter::ToggleCrouch()
 	else StartCrouch();
 }
 
+bool AVSlicesCharacter::TryToggleCrouch()
+{
+	if (!bIsCrouched && !GetCharacterMovement()->CanCrouchInCurrentState())
+		return false;
+	ToggleCrouch();
+	return true;
+}
+
 void AVSlicesCharacter::StartCrouch()
 {
 	Crouch();
@@ -165,49 +173,42 @@ void AVSlicesCharacter::StopCrouch()
 #pragma region JUMP
 
 void AVSlicesCharacter::Jump() 
+{
+	TryJump();
+}
+
+bool AVSlicesCharacter::TryJump(const bool bIsRetry)
 {
 	if (WallRunComponent->IsWallRunning()) //jump off wall run
 	{
 		WallRunComponent->Jump();
-		GetWorldTimerManager().SetTimer(JumpCooldownTimerHandle,this,&AVSlicesCharacter::ResetJumpCooldown, JumpCooldownTime,false);
-		return;
+		Cooldowns.Start(EParkourCooldown::Jump, GetWorld()->GetTimeSeconds(), JumpCooldownTime);
+		return true;
 	}
 	
 	if (LedgeSwingComponent && LedgeSwingComponent->IsHanging())
 	{
 		LedgeSwingComponent->Jump();
-		return;
+		return true;
 	}
-	if (VaultComponent && !VaultComponent->IsVaulting() && VaultComponent->TryVault(GetIsSprinting()))return; //check vaulting
-	if (!bCanJump) return;
+	if (VaultComponent && !VaultComponent->IsVaulting() && (!bIsRetry || VaultComponent->HasMovedSinceFailedVault(GetIsSprinting()))
+		&& VaultComponent->TryVault(GetIsSprinting()))return true; //check vaulting
+	// Checked up front so a press that cannot jump yet does not start the cooldown
+	if (!bCanJump || !CanJump()) return false;
     
 	Super::Jump(); 
-    
-	/* if (LedgeSwingComponent)
-	// {
-	// 	GetWorld()->GetTimerManager().SetTimer(LedgeDetectionTimerHandle, [this]()
-	// 	{
-	// 		if (!GetCharacterMovement()->IsFalling() || LedgeSwingComponent->IsHanging())
-	// 		{
-	// 			GetWorld()->GetTimerManager().ClearTimer(LedgeDetectionTimerHandle);
-	// 			return;
-	// 		}
-	// 		LedgeSwingComponent->TryGrab();
-	// 	}, 0.01f, true); 
-	// } */
+	// Ledges are grabbed by ULedgeSwingComponent's falling-state scanner, no per-jump polling
     
 	if (GetIsSprinting() && GetVelocity().Length()>=MaxJogSpeed) //boost if sprinting
-	{
-		FTimerHandle JumpTimerHandle;
-		GetWorld()->GetTimerManager().SetTimer(JumpTimerHandle, this, &AVSlicesCharacter::LaunchForward, 0.1f, false);
-	}
+		Cooldowns.Start(EParkourCooldown::LaunchForward, GetWorld()->GetTimeSeconds(), 0.1f);
 	if(bIsCrouched)
 		UnCrouch();
 	bCanJump = false;
     
 	float CurrentJumpCooldown = JumpCooldownTime;
 	if(GetIsSprinting()) CurrentJumpCooldown *= 1.5f;
-	GetWorldTimerManager().SetTimer(JumpCooldownTimerHandle,this,&AVSlicesCharacter::ResetJumpCooldown, CurrentJumpCooldown,false);
+	Cooldowns.Start(EParkourCooldown::Jump, GetWorld()->GetTimeSeconds(), CurrentJumpCooldown);
+	return true;
 }
 
 void AVSlicesCharacter::ResetJumpCooldown()
@@ -215,6 +216,20 @@ void AVSlicesCharacter::ResetJumpCooldown()
 	bCanJump = true;
 }
 
+void AVSlicesCharacter::OnCooldownsExpired(const uint8 ExpiredMask)
+{
+	auto HasExpired = [ExpiredMask](const EParkourCooldown Cooldown) { return (ExpiredMask & (1 << static_cast<int32>(Cooldown))) != 0; };
+	
+	if (HasExpired(EParkourCooldown::Jump))
+		ResetJumpCooldown();
+	if (HasExpired(EParkourCooldown::LaunchForward))
+		LaunchForward();
+	if (HasExpired(EParkourCooldown::Sprint) && SprintComponent)
+		SprintComponent->EndSprintCooldown();
+	if (HasExpired(EParkourCooldown::WallRun) && WallRunComponent && WallRunComponent->IsWallRunning())
+		WallRunComponent->StopWallRun();
+}
+
 void AVSlicesCharacter::LaunchForward()
 {
 	const float CurrentSpeed = GetVelocity().Length();
@@ -235,9 +250,6 @@ void AVSlicesCharacter::NotifyHit(UPrimitiveComponent* MyComp, AActor* Other,UPr
 {
 	Super::NotifyHit(MyComp, Other, OtherComp, bSelfMoved, HitLocation, HitNormal, NormalImpulse, Hit);
 
-	if(!OtherComp->IsSimulatingPhysics() && GrapplingHookComponent && GrapplingHookComponent->GetIsGrappling())
-		GrapplingHookComponent->ClimbAtEnd();
-	
 	if (WallRunComponent && !WallRunComponent->IsWallRunning() && Other && OtherComp)
 		WallRunComponent->TryWallRun(Hit);
 }
@@ -252,16 +264,19 @@ void AVSlicesCharacter::OnMovementModeChanged(EMovementMode PrevMovementMode, ui
 	Super::OnMovementModeChanged(PrevMovementMode, PreviousCustomMode);
 
 	const EMovementMode CurrentMovementMode = GetCharacterMovement()->MovementMode;
-	if ((PrevMovementMode == MOVE_Walking || PrevMovementMode == MOVE_Flying) && CurrentMovementMode == MOVE_Falling && GetVelocity().Z<=0.f)
+	// Flying covers scripted vaults, custom the grapple rope
+	if ((PrevMovementMode == MOVE_Walking || PrevMovementMode == MOVE_Flying || PrevMovementMode == MOVE_Custom) && CurrentMovementMode == MOVE_Falling && GetVelocity().Z<=0.f)
 	{
 		bInCoyoteTime = true;
 		CoyoteTimeRemaining = CoyoteTimeDuration;
 	}
-	if (CurrentMovementMode == MOVE_Walking || CurrentMovementMode == MOVE_Flying)
+	if (CurrentMovementMode == MOVE_Walking || CurrentMovementMode == MOVE_Flying || CurrentMovementMode == MOVE_Custom)
 	{
 		bInCoyoteTime = false;
 		CoyoteTimeRemaining = 0.0f;
 	}
+	
+	MovementEvents.OnMovementModeChanged.Broadcast(PrevMovementMode, PreviousCustomMode, CurrentMovementMode, GetCharacterMovement()->CustomMovementMode);
 }
 
 void AVSlicesCharacter::CalcCamera(float DeltaTime, FMinimalViewInfo& OutResult)
@@ -276,8 +291,7 @@ void AVSlicesCharacter::Landed(const FHitResult& Hit)
 {
 	Super::Landed(Hit);
 	
-	WallRunComponent->ResetWallRun();
-	WallRunComponent->StopWallRun();
+	MovementEvents.OnLanded.Broadcast(Hit);
 }
 
 #pragma endregion OVERRIDES
@@ -313,9 +327,24 @@ UWallRunComponent* AVSlicesCharacter::GetWallRunComponent() const
 	return WallRunComponent;
 }
 
+UGrapplingHookComponent* AVSlicesCharacter::GetGrapplingHookComponent() const
+{
+	return GrapplingHookComponent;
+}
+
+UParkourMovementComponent* AVSlicesCharacter::GetParkourMovement() const
+{
+	return static_cast<UParkourMovementComponent*>(GetCharacterMovement());
+}
+
 FSlopeInfo AVSlicesCharacter::GetSlopeInfo() const
 {
-	return SlopeComponent->GetSlopeInfo();
+	return SlopeComponent->ClassifySlope();
+}
+
+const FParkourGroundState& AVSlicesCharacter::GetGroundState() const
+{
+	return GetParkourMovement()->GetGroundState();
 }
 
 bool AVSlicesCharacter::GetIsSprinting() const
@@ -0,0 +1,182 @@
+#include "Commandlets/ParkourAffordanceBakeCommandlet.h"
+#include "Data/ParkourAffordanceIndex.h"
+#include "LoggingMacros.h"
+
+#if WITH_EDITOR
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "EngineUtils.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "UObject/SavePackage.h"
+#endif
+
+UParkourAffordanceBakeCommandlet::UParkourAffordanceBakeCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UParkourAffordanceBakeCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString MapsParam = TEXT("/Game/Maps/Parkour");
+	FParse::Value(*Params, TEXT("Maps="), MapsParam);
+	
+	TArray<FString> Maps;
+	MapsParam.ParseIntoArray(Maps, TEXT("+"));
+	
+	int32 Failures = 0;
+	for (const FString& Map : Maps)
+	{
+		if (!BakeMap(Map))
+			Failures++;
+	}
+	return Failures;
+#else
+	LOG_ERROR(LogParkourWorld, "ParkourAffordanceBake needs an editor build");
+	return 1;
+#endif
+}
+
+#if WITH_EDITOR
+bool UParkourAffordanceBakeCommandlet::BakeMap(const FString& MapPackageName) const
+{
+	UPackage* MapPackage = LoadPackage(nullptr, *MapPackageName, LOAD_None);
+	UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+	if (!World)
+	{
+		LOG_ERROR(LogParkourWorld, "Failed to load map %s", *MapPackageName);
+		return false;
+	}
+	
+	// A loaded map has no registered components, so transforms and bounds are not valid until the world is set up
+	const bool bInitWorld = !World->bIsWorldInitialized;
+	World->AddToRoot();
+	if (bInitWorld)
+	{
+		World->WorldType = EWorldType::Editor;
+		World->InitWorld(UWorld::InitializationValues()
+			.InitializeScenes(false)
+			.AllowAudioPlayback(false)
+			.RequiresHitProxies(false)
+			.CreatePhysicsScene(false)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(false)
+			.SetTransactional(false)
+			.CreateFXSystem(false));
+	}
+	World->UpdateWorldComponents(true, false);
+	
+	const FString PackageName = UParkourAffordanceIndex::GetPackageNameForMap(FPackageName::GetShortName(MapPackageName));
+	UPackage* Package = CreatePackage(*PackageName);
+	UParkourAffordanceIndex* Index = NewObject<UParkourAffordanceIndex>(Package, *FPackageName::GetShortName(PackageName), RF_Public | RF_Standalone);
+	
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		TInlineComponentArray<UPrimitiveComponent*> Components(*It);
+		for (const UPrimitiveComponent* Component : Components)
+		{
+			if (Component->Mobility != EComponentMobility::Static || !Component->IsQueryCollisionEnabled())
+				continue;
+			
+			// Static geometry the index cannot describe (landscape, BSP, other object types) stays opaque, so runtime
+			// queries there keep tracing everything
+			const UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Component);
+			if (MeshComponent && MeshComponent->GetStaticMesh() && Component->GetCollisionObjectType() == ECC_WorldStatic)
+				BakeComponent(MeshComponent, Index);
+			else
+				AddOpaqueVolume(Component->Bounds.GetBox(), Index);
+		}
+	}
+	
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+	const FString Filename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+	const bool bSaved = UPackage::SavePackage(Package, Index, *Filename, SaveArgs);
+	
+	if (bInitWorld)
+		World->CleanupWorld();
+	World->RemoveFromRoot();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	
+	if (!bSaved)
+	{
+		LOG_ERROR(LogParkourWorld, "Failed to save %s", *Filename);
+		return false;
+	}
+	
+	LOG_INFO(LogParkourWorld, "Baked %s: %d wall tops, %d poles, %d opaque volumes", *MapPackageName, Index->WallTops.Num(), Index->Poles.Num(), Index->OpaqueVolumes.Num());
+	return true;
+}
+
+void UParkourAffordanceBakeCommandlet::BakeComponent(const UStaticMeshComponent* Component, UParkourAffordanceIndex* Index) const
+{
+	// HISM derives from ISM; each instance is its own piece of geometry
+	if (const UInstancedStaticMeshComponent* Instanced = Cast<UInstancedStaticMeshComponent>(Component))
+	{
+		FTransform InstanceTransform;
+		for (int32 i = 0; i < Instanced->GetInstanceCount(); i++)
+		{
+			if (Instanced->GetInstanceTransform(i, InstanceTransform, true))
+				BakeMesh(Instanced->GetStaticMesh(), InstanceTransform, Index);
+		}
+		return;
+	}
+	BakeMesh(Component->GetStaticMesh(), Component->GetComponentTransform(), Index);
+}
+
+void UParkourAffordanceBakeCommandlet::BakeMesh(const UStaticMesh* Mesh, const FTransform& Transform, UParkourAffordanceIndex* Index) const
+{
+	const UBodySetup* BodySetup = Mesh->GetBodySetup();
+	const FKAggregateGeom* Geom = BodySetup ? &BodySetup->AggGeom : nullptr;
+	
+	// Single box collision on a yaw-only transform: footprint with a flat top
+	if (Geom && Geom->GetElementCount() == 1 && Geom->BoxElems.Num() == 1)
+	{
+		const FKBoxElem& Box = Geom->BoxElems[0];
+		const FTransform BoxTransform = Box.GetTransform() * Transform;
+		if (BoxTransform.GetUnitAxis(EAxis::Z).Z > 0.999f)
+		{
+			const FVector Extent = FVector(Box.X, Box.Y, Box.Z) * 0.5f * BoxTransform.GetScale3D().GetAbs();
+			const FVector Center = BoxTransform.GetLocation();
+			
+			FParkourWallTop& Top = Index->WallTops.AddDefaulted_GetRef();
+			Top.Center = FVector2f(FVector2D(Center));
+			Top.Axis = FVector2f(FVector2D(BoxTransform.GetUnitAxis(EAxis::X)).GetSafeNormal());
+			Top.HalfExtents = FVector2f(Extent.X, Extent.Y);
+			Top.BottomZ = Center.Z - Extent.Z;
+			Top.TopZ = Center.Z + Extent.Z;
+			return;
+		}
+	}
+	
+	// Long, thin and horizontal: pole along its longest local axis
+	const FBox LocalBounds = Mesh->GetBoundingBox();
+	const FVector Extent = LocalBounds.GetExtent() * Transform.GetScale3D().GetAbs();
+	const int32 LongAxis = Extent.X >= Extent.Y && Extent.X >= Extent.Z ? 0 : (Extent.Y >= Extent.Z ? 1 : 2);
+	const FVector AxisDir = Transform.GetUnitAxis(static_cast<EAxis::Type>(LongAxis + 1));
+	const float Radius = FMath::Max(Extent[(LongAxis + 1) % 3], Extent[(LongAxis + 2) % 3]);
+	if (Radius <= MaxPoleRadius && Extent[LongAxis] * 2.f >= MinPoleLength && FMath::Abs(AxisDir.Z) < 0.1f)
+	{
+		const FVector Center = Transform.TransformPosition(LocalBounds.GetCenter());
+		FParkourPoleAxis& Pole = Index->Poles.AddDefaulted_GetRef();
+		Pole.Start = FVector3f(Center - AxisDir * Extent[LongAxis]);
+		Pole.End = FVector3f(Center + AxisDir * Extent[LongAxis]);
+		Pole.Radius = Radius;
+		return;
+	}
+	
+	AddOpaqueVolume(LocalBounds.TransformBy(Transform), Index);
+}
+
+void UParkourAffordanceBakeCommandlet::AddOpaqueVolume(const FBox& Bounds, UParkourAffordanceIndex* Index)
+{
+	FParkourOpaqueVolume& Volume = Index->OpaqueVolumes.AddDefaulted_GetRef();
+	Volume.Min = FVector3f(Bounds.Min);
+	Volume.Max = FVector3f(Bounds.Max);
+}
+#endif
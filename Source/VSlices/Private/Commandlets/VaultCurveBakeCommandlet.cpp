@@ -0,0 +1,133 @@
+#include "Commandlets/VaultCurveBakeCommandlet.h"
+#include "Animation/AnimMontage.h"
+#include "Characters/VSlicesCharacter.h"
+#include "Characters/Components/VaultComponent.h"
+#include "Data/VaultRootMotionCurves.h"
+#include "LoggingMacros.h"
+
+#if WITH_EDITOR
+#include "UObject/SavePackage.h"
+#endif
+
+UVaultCurveBakeCommandlet::UVaultCurveBakeCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UVaultCurveBakeCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString CharacterPath = TEXT("/Game/Blueprints/Characters/BP_Character");
+	FParse::Value(*Params, TEXT("Character="), CharacterPath);
+	
+	const FString ClassPath = FString::Printf(TEXT("%s.%s_C"), *CharacterPath, *FPackageName::GetShortName(CharacterPath));
+	const UClass* CharacterClass = LoadClass<AVSlicesCharacter>(nullptr, *ClassPath);
+	const AVSlicesCharacter* Character = CharacterClass ? CharacterClass->GetDefaultObject<AVSlicesCharacter>() : nullptr;
+	const UVaultComponent* Vault = Character ? Character->GetVaultComponent() : nullptr;
+	if (!Vault)
+	{
+		LOG_ERROR(LogParkourVault, "No vault component on %s", *ClassPath);
+		return 1;
+	}
+	
+	UPackage* Package = CreatePackage(UVaultRootMotionCurves::PackageName);
+	UVaultRootMotionCurves* Curves = NewObject<UVaultRootMotionCurves>(Package, *FPackageName::GetShortName(UVaultRootMotionCurves::PackageName), RF_Public | RF_Standalone);
+	
+	// Vaults travel over and come back down, so their height is an arc normalized by its peak; climbs end up high
+	const TPair<EVaultType, UAnimMontage*> Montages[] = {
+		{EVaultType::Vault_Short, Vault->VaultShortMontage},
+		{EVaultType::Vault_Tall, Vault->VaultTallMontage},
+		{EVaultType::Climb_Short, Vault->ClimbShortMontage},
+		{EVaultType::Climb_Tall, Vault->ClimbTallMontage}
+	};
+	int32 Baked = 0;
+	for (const TPair<EVaultType, UAnimMontage*>& Entry : Montages)
+	{
+		const bool bIsVault = Entry.Key == EVaultType::Vault_Short || Entry.Key == EVaultType::Vault_Tall;
+		if (BakeMontage(Entry.Value, bIsVault, Curves->Curves[static_cast<int32>(Entry.Key)]))
+			Baked++;
+	}
+	
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+	const FString Filename = FPackageName::LongPackageNameToFilename(UVaultRootMotionCurves::PackageName, FPackageName::GetAssetPackageExtension());
+	if (!UPackage::SavePackage(Package, Curves, *Filename, SaveArgs))
+	{
+		LOG_ERROR(LogParkourVault, "Failed to save %s", *Filename);
+		return 1;
+	}
+	
+	LOG_INFO(LogParkourVault, "Baked %d/%d vault curves from %s", Baked, UVaultRootMotionCurves::NumVaultTypes, *ClassPath);
+	return 0;
+#else
+	LOG_ERROR(LogParkourVault, "VaultCurveBake needs an editor build");
+	return 1;
+#endif
+}
+
+#if WITH_EDITOR
+bool UVaultCurveBakeCommandlet::BakeMontage(UAnimMontage* Montage, const bool bUpToPeak, FVaultRootMotionCurve& OutCurve)
+{
+	if (!Montage || !Montage->HasRootMotion())
+	{
+		LOG_WARNING(LogParkourVault, "%s has no root motion, vault will use the solver path", *GetNameSafe(Montage));
+		return false;
+	}
+	
+	const float Duration = Montage->GetPlayLength();
+	const int32 NumSamples = FMath::Clamp(FMath::CeilToInt(Duration * SampleRate) + 1, 2, MaxSamples);
+	const FAnimExtractContext Context;
+	
+	// Cumulative root displacement from the start of the montage
+	TArray<FVector> Offsets;
+	Offsets.Reserve(NumSamples);
+	for (int32 i = 0; i < NumSamples; i++)
+	{
+		const float Time = Duration * i / (NumSamples - 1);
+		Offsets.Add(Montage->ExtractRootMotionFromTrackRange(0.f, Time, Context).GetTranslation());
+	}
+	
+	// Root space differs per skeleton, so take forward from the overall horizontal travel
+	const FVector Travel2D(Offsets.Last().X, Offsets.Last().Y, 0.f);
+	const bool bHasTravel = Travel2D.SizeSquared() > 1.f;
+	const FVector ForwardAxis = bHasTravel ? Travel2D.GetUnsafeNormal() : FVector::YAxisVector;
+	const float TravelLength = bHasTravel ? Travel2D.Size() : 1.f;
+	
+	float UpScale = Offsets.Last().Z;
+	if (bUpToPeak)
+	{
+		UpScale = 0.f;
+		for (const FVector& Offset : Offsets)
+			UpScale = FMath::Max(UpScale, Offset.Z);
+	}
+	UpScale = FMath::Abs(UpScale) > 1.f ? UpScale : 1.f;
+	
+	TArray<float> Forward, Up;
+	Forward.Reserve(NumSamples);
+	Up.Reserve(NumSamples);
+	for (int32 i = 0; i < NumSamples; i++)
+	{
+		// Without horizontal travel in the animation, progress is linear in time
+		Forward.Add(bHasTravel ? FVector::DotProduct(Offsets[i], ForwardAxis) / TravelLength : static_cast<float>(i) / (NumSamples - 1));
+		Up.Add(Offsets[i].Z / UpScale);
+	}
+	
+	OutCurve.Montage = Montage;
+	OutCurve.Duration = Duration;
+	OutCurve.bUpToPeak = bUpToPeak;
+	OutCurve.ForwardRange = FVector2f(FMath::Min(Forward), FMath::Max(Forward));
+	OutCurve.UpRange = FVector2f(FMath::Min(Up), FMath::Max(Up));
+	OutCurve.Forward.SetNumUninitialized(NumSamples);
+	OutCurve.Up.SetNumUninitialized(NumSamples);
+	for (int32 i = 0; i < NumSamples; i++)
+	{
+		OutCurve.Forward[i] = FVaultRootMotionCurve::Quantize(Forward[i], OutCurve.ForwardRange);
+		OutCurve.Up[i] = FVaultRootMotionCurve::Quantize(Up[i], OutCurve.UpRange);
+	}
+	FVaultRootMotionCurve::ComputeFingerprint(Montage, OutCurve.Fingerprint);
+	return true;
+}
+#endif
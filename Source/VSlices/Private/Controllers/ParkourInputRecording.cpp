@@ -0,0 +1,152 @@
+#include "Controllers/ParkourInputRecording.h"
+#include "HAL/FileManager.h"
+#include "LoggingMacros.h"
+#include "Misc/Paths.h"
+
+int16 FParkourInputRecordingFormat::Quantize(const EParkourInputAction Action, const double Value)
+{
+	const float Scale = Action == EParkourInputAction::Look ? LookScale : MoveScale;
+	return static_cast<int16>(FMath::Clamp(FMath::RoundToInt(Value * Scale), static_cast<int32>(MIN_int16), static_cast<int32>(MAX_int16)));
+}
+
+double FParkourInputRecordingFormat::Dequantize(const EParkourInputAction Action, const int16 Value)
+{
+	const float Scale = Action == EParkourInputAction::Look ? LookScale : MoveScale;
+	return Value / Scale;
+}
+
+FString FParkourInputRecordingFormat::GetPath(const FString& Name)
+{
+	if (FPaths::IsRelative(Name))
+		return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("InputRecordings"), Name + TEXT(".pkin"));
+	return Name;
+}
+
+#pragma region RECORDER
+
+FParkourInputRecorder::~FParkourInputRecorder()
+{
+	Close();
+}
+
+bool FParkourInputRecorder::Open(const FString& Name, float StepSeconds, const FString& MapName)
+{
+	const FString Path = FParkourInputRecordingFormat::GetPath(Name);
+	Writer.Reset(IFileManager::Get().CreateFileWriter(*Path));
+	if (!Writer)
+	{
+		LOG_ERROR(LogParkourInput, "Could not create input recording %s", *Path);
+		return false;
+	}
+	
+	uint32 Magic = FParkourInputRecordingFormat::Magic;
+	uint16 Version = FParkourInputRecordingFormat::Version;
+	FString Map = MapName;
+	*Writer << Magic << Version << StepSeconds << Map;
+	LastFrame = 0;
+	NumEvents = 0;
+	
+	LOG_INFO(LogParkourInput, "Recording input to %s", *Path);
+	return true;
+}
+
+FVector2D FParkourInputRecorder::Record(const uint32 Frame, const EParkourInputAction Action, const FVector2D& Value)
+{
+	if (!Writer)
+		return Value;
+	
+	uint32 FrameDelta = Frame - LastFrame;
+	uint8 ActionId = static_cast<uint8>(Action);
+	Writer->SerializeIntPacked(FrameDelta);
+	*Writer << ActionId;
+	LastFrame = Frame;
+	NumEvents++;
+	
+	if (!FParkourInputRecordingFormat::HasAxisValue(Action))
+		return Value;
+	
+	int16 X = FParkourInputRecordingFormat::Quantize(Action, Value.X);
+	int16 Y = FParkourInputRecordingFormat::Quantize(Action, Value.Y);
+	*Writer << X << Y;
+	return FVector2D(FParkourInputRecordingFormat::Dequantize(Action, X), FParkourInputRecordingFormat::Dequantize(Action, Y));
+}
+
+void FParkourInputRecorder::Close()
+{
+	if (!Writer)
+		return;
+	
+	Writer->Close();
+	Writer.Reset();
+	LOG_INFO(LogParkourInput, "Input recording closed: %u events over %u frames", NumEvents, LastFrame);
+}
+
+#pragma endregion RECORDER
+
+#pragma region PLAYER
+
+FParkourInputPlayer::~FParkourInputPlayer()
+{
+	if (Reader)
+		Reader->Close();
+}
+
+bool FParkourInputPlayer::Open(const FString& Name)
+{
+	const FString Path = FParkourInputRecordingFormat::GetPath(Name);
+	Reader.Reset(IFileManager::Get().CreateFileReader(*Path));
+	if (!Reader)
+	{
+		LOG_ERROR(LogParkourInput, "Could not open input recording %s", *Path);
+		return false;
+	}
+	
+	uint32 Magic = 0;
+	uint16 Version = 0;
+	FString Map;
+	*Reader << Magic << Version << StepSeconds << Map;
+	if (Reader->IsError() || Magic != FParkourInputRecordingFormat::Magic || Version != FParkourInputRecordingFormat::Version)
+	{
+		LOG_ERROR(LogParkourInput, "%s is not a version %u input recording", *Path, FParkourInputRecordingFormat::Version);
+		Reader.Reset();
+		return false;
+	}
+	
+	LOG_INFO(LogParkourInput, "Replaying input from %s, recorded on %s at %.4fs per frame", *Path, *Map, StepSeconds);
+	NextFrame = 0;
+	bFinished = false;
+	ReadNext();
+	return true;
+}
+
+void FParkourInputPlayer::ReadNext()
+{
+	if (Reader->AtEnd())
+	{
+		bFinished = true;
+		return;
+	}
+	
+	uint32 FrameDelta = 0;
+	uint8 ActionId = 0;
+	Reader->SerializeIntPacked(FrameDelta);
+	*Reader << ActionId;
+	NextFrame += FrameDelta;
+	NextAction = static_cast<EParkourInputAction>(ActionId);
+	NextValue = FVector2D::ZeroVector;
+	
+	if (FParkourInputRecordingFormat::HasAxisValue(NextAction))
+	{
+		int16 X = 0, Y = 0;
+		*Reader << X << Y;
+		NextValue = FVector2D(FParkourInputRecordingFormat::Dequantize(NextAction, X), FParkourInputRecordingFormat::Dequantize(NextAction, Y));
+	}
+	
+	if (Reader->IsError() || NextAction >= EParkourInputAction::Num)
+	{
+		LOG_ERROR(LogParkourInput, "Input recording is truncated or corrupt, stopping replay at frame %u", NextFrame);
+		bFinished = true;
+	}
+}
+
+#pragma endregion PLAYER
@@ -4,16 +4,19 @@
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "Characters/VSlicesCharacter.h"
+#include "Characters/Components/GrapplingHookComponent.h"
 #include "LoggingMacros.h"
+#include "Misc/App.h"
 
 void AVSlicesPlayerController::OnPossess(APawn* InPawn)
 {
 	Super::OnPossess(InPawn);
     
 	PlayerCharacter = Cast<AVSlicesCharacter>(InPawn);
+	InputBuffer.Reset();
 	if (!PlayerCharacter)
 	{
-		LOG_ERROR("PlayerCharacter is null!");
+		LOG_ERROR(LogParkourInput, "PlayerCharacter is null!");
 	}
 }
 
@@ -25,6 +28,14 @@ void AVSlicesPlayerController::BeginPlay()
 	{
 		Subsystem->AddMappingContext(DefaultMappingContext, 0);
 	}
+	if (IsLocalController())
+		StartInputRecordingOrReplay();
+}
+
+void AVSlicesPlayerController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopInputRecordingOrReplay();
+	Super::EndPlay(EndPlayReason);
 }
 
 void AVSlicesPlayerController::SetupInputComponent()
@@ -41,49 +52,200 @@ void AVSlicesPlayerController::SetupInputComponent()
 		EnhancedInput->BindAction(SprintAction, ETriggerEvent::Triggered, this, &AVSlicesPlayerController::Sprint);
 		EnhancedInput->BindAction(SprintAction, ETriggerEvent::Completed, this, &AVSlicesPlayerController::UnSprint);
 		EnhancedInput->BindAction(GrappleAction, ETriggerEvent::Completed, this, &AVSlicesPlayerController::ShootGrapplingHook);
+		// Completed carries a zero value, which hands the rope back to its default reel
+		if (ReelAction)
+		{
+			EnhancedInput->BindAction(ReelAction, ETriggerEvent::Triggered, this, &AVSlicesPlayerController::Reel);
+			EnhancedInput->BindAction(ReelAction, ETriggerEvent::Completed, this, &AVSlicesPlayerController::Reel);
+		}
 	}
 	else
 	{
-		UE_LOG(LogTemplateCharacter, Error, TEXT("'%s' Failed to find an Enhanced Input component!"), *GetNameSafe(this));
+		LOG_ERROR(LogParkourInput, "'%s' Failed to find an Enhanced Input component!", *GetNameSafe(this));
+	}
+}
+
+void AVSlicesPlayerController::PlayerTick(const float DeltaTime)
+{
+	// Recorded events were raised by ProcessPlayerInput inside this frame's PlayerTick; replaying them just before it
+	// keeps them ahead of the rotation update, like live input
+	if (InputPlayer)
+	{
+		InputPlayer->PlayFrame(InputFrame, [this](const EParkourInputAction Action, const FVector2D& Value) { ExecuteInput(Action, Value); });
+		if (InputPlayer->IsFinished())
+		{
+			LOG_INFO(LogParkourInput, "Input replay finished after %u frames", InputFrame);
+			StopInputRecordingOrReplay();
+			if (FApp::IsUnattended())
+				FPlatformMisc::RequestExit(false, TEXT("ParkourReplay"));
+		}
 	}
+	
+	Super::PlayerTick(DeltaTime);
+	InputFrame++;
+	
+	ConsumeBufferedIntents();
+	if (PlayerCharacter)
+		PlayerCharacter->GetGrapplingHookComponent()->UpdateAimPreview();
 }
 
 void AVSlicesPlayerController::Move(const FInputActionValue& Value)
 {
-	if (PlayerCharacter) PlayerCharacter->Move(Value);
+	DispatchInput(EParkourInputAction::Move, Value.Get<FVector2D>());
 }
 
 void AVSlicesPlayerController::Look(const FInputActionValue& Value)
 {
-	if (PlayerCharacter) PlayerCharacter->Look(Value);
+	DispatchInput(EParkourInputAction::Look, Value.Get<FVector2D>());
 }
 
 void AVSlicesPlayerController::JumpPressed()
 {
-	if (PlayerCharacter) PlayerCharacter->Jump();
+	DispatchInput(EParkourInputAction::JumpPressed);
 }
 
 void AVSlicesPlayerController::JumpReleased()
 {
-	if (PlayerCharacter) PlayerCharacter->StopJumping();
+	DispatchInput(EParkourInputAction::JumpReleased);
 }
 
 void AVSlicesPlayerController::Crouch()
 {
-	if (PlayerCharacter) PlayerCharacter->ToggleCrouch();
+	DispatchInput(EParkourInputAction::Crouch);
 }
 
 void AVSlicesPlayerController::Sprint()
 {
-	if (PlayerCharacter) PlayerCharacter->StartSprinting();
+	DispatchInput(EParkourInputAction::Sprint);
 }
 
 void AVSlicesPlayerController::UnSprint()
 {
-	if (PlayerCharacter) PlayerCharacter->StopSprinting();
+	DispatchInput(EParkourInputAction::UnSprint);
 }
 
 void AVSlicesPlayerController::ShootGrapplingHook()
 {
-	if (PlayerCharacter) PlayerCharacter->ShootGrapplingHook();
+	DispatchInput(EParkourInputAction::Grapple);
+}
+
+void AVSlicesPlayerController::Reel(const FInputActionValue& Value)
+{
+	DispatchInput(EParkourInputAction::Reel, FVector2D(Value.Get<float>(), 0.0));
+}
+
+#pragma region RECORD AND REPLAY
+
+void AVSlicesPlayerController::DispatchInput(const EParkourInputAction Action, const FVector2D& Value)
+{
+	if (InputPlayer)
+		return;
+	ExecuteInput(Action, InputRecorder ? InputRecorder->Record(InputFrame, Action, Value) : Value);
+}
+
+void AVSlicesPlayerController::ExecuteInput(const EParkourInputAction Action, const FVector2D& Value)
+{
+	switch (Action)
+	{
+	case EParkourInputAction::Move:         if (PlayerCharacter) PlayerCharacter->Move(FInputActionValue(Value)); break;
+	case EParkourInputAction::Look:         if (PlayerCharacter) PlayerCharacter->Look(FInputActionValue(Value)); break;
+	case EParkourInputAction::JumpPressed:  BufferIntent(EParkourInputIntent::Jump); break;
+	case EParkourInputAction::JumpReleased: if (PlayerCharacter) PlayerCharacter->StopJumping(); break;
+	case EParkourInputAction::Crouch:       BufferIntent(EParkourInputIntent::Crouch); break;
+	case EParkourInputAction::Sprint:       if (PlayerCharacter) PlayerCharacter->StartSprinting(); break;
+	case EParkourInputAction::UnSprint:     if (PlayerCharacter) PlayerCharacter->StopSprinting(); break;
+	case EParkourInputAction::Grapple:      BufferIntent(EParkourInputIntent::Grapple); break;
+	case EParkourInputAction::Reel:         if (PlayerCharacter) PlayerCharacter->GetGrapplingHookComponent()->SetReelInput(Value.X); break;
+	default: break;
+	}
+}
+
+void AVSlicesPlayerController::StartInputRecordingOrReplay()
+{
+	FString Name;
+	if (FParse::Value(FCommandLine::Get(), TEXT("ParkourReplay="), Name))
+	{
+		InputPlayer = MakeUnique<FParkourInputPlayer>();
+		if (!InputPlayer->Open(Name))
+			InputPlayer.Reset();
+	}
+	else if (FParse::Value(FCommandLine::Get(), TEXT("ParkourRecord="), Name))
+	{
+		InputRecorder = MakeUnique<FParkourInputRecorder>();
+		if (!InputRecorder->Open(Name, RecordingStepSeconds, GetWorld()->GetMapName()))
+			InputRecorder.Reset();
+	}
+	if (!InputPlayer && !InputRecorder)
+		return;
+	
+	// Replays step at the recorded rate, so the same inputs land on the same simulated frames
+	InputFrame = 0;
+	bWasFixedTimeStep = FApp::UseFixedTimeStep();
+	PreviousFixedDeltaTime = FApp::GetFixedDeltaTime();
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(InputPlayer ? InputPlayer->GetStepSeconds() : RecordingStepSeconds);
+}
+
+void AVSlicesPlayerController::StopInputRecordingOrReplay()
+{
+	if (!InputPlayer && !InputRecorder)
+		return;
+	
+	InputPlayer.Reset();
+	InputRecorder.Reset();
+	FApp::SetUseFixedTimeStep(bWasFixedTimeStep);
+	FApp::SetFixedDeltaTime(PreviousFixedDeltaTime);
+}
+
+#pragma endregion RECORD AND REPLAY
+
+#pragma region INPUT BUFFER
+
+void AVSlicesPlayerController::BufferIntent(const EParkourInputIntent Intent)
+{
+	InputBuffer.Push(Intent, GetWorld()->GetTimeSeconds(), GFrameCounter);
+	// Try right away so an unblocked press does not wait a frame
+	ConsumeBufferedIntents();
+}
+
+void AVSlicesPlayerController::ConsumeBufferedIntents()
+{
+	if (!PlayerCharacter)
+		return;
+	
+	const double Now = GetWorld()->GetTimeSeconds();
+	const double MaxBufferTime = FMath::Max3(JumpBufferTime, GrappleBufferTime, CrouchBufferTime);
+	InputBuffer.ConsumePending(Now - MaxBufferTime, [this, Now](FParkourBufferedInput& Input)
+	{
+		// Expired presses are dropped like before, live ones stay until the character accepts them
+		if (Now - Input.Time > GetBufferTime(Input.Intent))
+			return true;
+		const bool bIsRetry = Input.Attempts > 0;
+		Input.Attempts = static_cast<uint8>(FMath::Min(Input.Attempts + 1, static_cast<int32>(MAX_uint8)));
+		return TryIntent(Input.Intent, bIsRetry);
+	});
+}
+
+bool AVSlicesPlayerController::TryIntent(const EParkourInputIntent Intent, const bool bIsRetry) const
+{
+	switch (Intent)
+	{
+	case EParkourInputIntent::Jump:    return PlayerCharacter->TryJump(bIsRetry);
+	case EParkourInputIntent::Grapple: return PlayerCharacter->ShootGrapplingHook();
+	case EParkourInputIntent::Crouch:  return PlayerCharacter->TryToggleCrouch();
+	default:                           return true;
+	}
 }
+
+float AVSlicesPlayerController::GetBufferTime(const EParkourInputIntent Intent) const
+{
+	switch (Intent)
+	{
+	case EParkourInputIntent::Jump:    return JumpBufferTime;
+	case EParkourInputIntent::Grapple: return GrappleBufferTime;
+	case EParkourInputIntent::Crouch:  return CrouchBufferTime;
+	default:                           return 0.f;
+	}
+}
+
+#pragma endregion INPUT BUFFER
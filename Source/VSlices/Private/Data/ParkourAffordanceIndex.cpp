@@ -0,0 +1,6 @@
+#include "Data/ParkourAffordanceIndex.h"
+
+FString UParkourAffordanceIndex::GetPackageNameForMap(const FString& MapName)
+{
+	return FString::Printf(TEXT("/Game/ParkourData/%s_Affordances"), *MapName);
+}
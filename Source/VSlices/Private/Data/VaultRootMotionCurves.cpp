@@ -0,0 +1,78 @@
+#include "Data/VaultRootMotionCurves.h"
+#include "Animation/AnimMontage.h"
+#include "Characters/Components/VaultComponent.h"
+#include "LoggingMacros.h"
+
+const TCHAR* UVaultRootMotionCurves::PackageName = TEXT("/Game/ParkourData/VaultRootMotionCurves");
+
+FSoftObjectPath UVaultRootMotionCurves::GetDefaultPath()
+{
+	return FSoftObjectPath(FString::Printf(TEXT("%s.%s"), PackageName, *FPackageName::GetShortName(PackageName)));
+}
+
+uint16 FVaultRootMotionCurve::Quantize(const float Value, const FVector2f& Range)
+{
+	const float Span = FMath::Max(Range.Y - Range.X, UE_KINDA_SMALL_NUMBER);
+	return static_cast<uint16>(FMath::RoundToInt(FMath::Clamp((Value - Range.X) / Span, 0.f, 1.f) * MAX_uint16));
+}
+
+float FVaultRootMotionCurve::Dequantize(const uint16 Value, const FVector2f& Range)
+{
+	return FMath::Lerp(Range.X, Range.Y, static_cast<float>(Value) / MAX_uint16);
+}
+
+float FVaultRootMotionCurve::Sample(const TArray<uint16>& Samples, const FVector2f& Range, const float Alpha)
+{
+	const float Position = FMath::Clamp(Alpha, 0.f, 1.f) * (Samples.Num() - 1);
+	const int32 Index = FMath::Min(FMath::FloorToInt(Position), Samples.Num() - 2);
+	return FMath::Lerp(Dequantize(Samples[Index], Range), Dequantize(Samples[Index + 1], Range), Position - Index);
+}
+
+#if WITH_EDITOR
+void FVaultRootMotionCurve::ComputeFingerprint(const UAnimMontage* InMontage, TArray<FVector3f>& OutFingerprint)
+{
+	const float PlayLength = InMontage->GetPlayLength();
+	const FAnimExtractContext Context;
+	OutFingerprint.Reset(NumFingerprintSamples);
+	for (int32 i = 1; i <= NumFingerprintSamples; i++)
+		OutFingerprint.Add(FVector3f(InMontage->ExtractRootMotionFromTrackRange(0.f, PlayLength * i / NumFingerprintSamples, Context).GetTranslation()));
+}
+
+bool FVaultRootMotionCurve::MatchesMontage(const UAnimMontage* InMontage) const
+{
+	if (CheckedMontage.Get() == InMontage)
+		return bCheckedMontageMatches;
+	
+	// Montages can be edited in the editor after the bake; the root motion itself is what the curve depends on
+	bool bMatches = Fingerprint.Num() == NumFingerprintSamples && FMath::IsNearlyEqual(Duration, InMontage->GetPlayLength(), 1e-3f);
+	if (bMatches)
+	{
+		TArray<FVector3f> Current;
+		ComputeFingerprint(InMontage, Current);
+		for (int32 i = 0; i < NumFingerprintSamples && bMatches; i++)
+			bMatches = Current[i].Equals(Fingerprint[i], FingerprintTolerance);
+	}
+	if (!bMatches)
+		LOG_WARNING(LogParkourVault, "%s changed since the vault curve bake, using the solver until -run=VaultCurveBake is rerun", *GetNameSafe(InMontage));
+	
+	CheckedMontage = InMontage;
+	bCheckedMontageMatches = bMatches;
+	return bMatches;
+}
+#endif
+
+const FVaultRootMotionCurve* UVaultRootMotionCurves::Find(const EVaultType VaultType, const UAnimMontage* Montage) const
+{
+	const int32 Index = static_cast<int32>(VaultType);
+	if (Index < 0 || Index >= NumVaultTypes || !Montage)
+		return nullptr;
+	
+	const FVaultRootMotionCurve& Curve = Curves[Index];
+	if (!Curve.IsValid() || Curve.Montage.ToSoftObjectPath() != FSoftObjectPath(Montage))
+		return nullptr;
+#if WITH_EDITOR
+	if (!Curve.MatchesMontage(Montage))
+		return nullptr;
+#endif
+	return &Curve;
+}
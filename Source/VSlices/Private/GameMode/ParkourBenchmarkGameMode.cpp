@@ -0,0 +1,295 @@
+#include "GameMode/ParkourBenchmarkGameMode.h"
+#include "Characters/VSlicesCharacter.h"
+#include "GameFramework/PlayerStart.h"
+#include "InputActionValue.h"
+#include "EngineUtils.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "LoggingMacros.h"
+
+AParkourBenchmarkGameMode::AParkourBenchmarkGameMode()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PrePhysics; // scripted input lands before movement
+
+	// Runners are the only pawns being measured
+	if (DefaultPawnClass && DefaultPawnClass->IsChildOf(AVSlicesCharacter::StaticClass()))
+		RunnerClass = *DefaultPawnClass;
+	bStartPlayersAsSpectators = true;
+
+	// Default loop: accelerate, sprint, slide, jump into whatever is ahead (vault, wall run, ledge), then grapple
+	Script = {
+		{0,   EParkourBenchmarkAction::MoveForward},
+		{30,  EParkourBenchmarkAction::Sprint},
+		{90,  EParkourBenchmarkAction::Crouch},
+		{120, EParkourBenchmarkAction::StopCrouch},
+		{150, EParkourBenchmarkAction::Jump},
+		{160, EParkourBenchmarkAction::StopJump},
+		{200, EParkourBenchmarkAction::Jump},
+		{210, EParkourBenchmarkAction::StopJump},
+		{240, EParkourBenchmarkAction::Grapple},
+		{300, EParkourBenchmarkAction::StopSprint},
+		{330, EParkourBenchmarkAction::StopMoving}
+	};
+}
+
+void AParkourBenchmarkGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+	FParse::Value(CommandLine, TEXT("BenchRunners="), NumRunners);
+	FParse::Value(CommandLine, TEXT("BenchFrames="), BenchmarkFrames);
+	FParse::Value(CommandLine, TEXT("BenchWarmup="), WarmupFrames);
+	FParse::Value(CommandLine, TEXT("BenchSeed="), RandomSeed);
+	FParse::Value(CommandLine, TEXT("BenchOut="), ReportName);
+	if (FParse::Param(CommandLine, TEXT("BenchSimulation")))
+		bUseParkourSimulation = true;
+
+	NumRunners = FMath::Max(NumRunners, 1);
+	BenchmarkFrames = FMath::Max(BenchmarkFrames, 1);
+	ScriptLength = FMath::Max(ScriptLength, 1);
+
+	// Fixed step keeps the run deterministic and independent of how fast the machine is
+	bWasFixedTimeStep = FApp::UseFixedTimeStep();
+	PreviousFixedDeltaTime = FApp::GetFixedDeltaTime();
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(FixedDeltaTime);
+}
+
+void AParkourBenchmarkGameMode::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!RunnerClass)
+	{
+		LOG_ERROR(LogParkourBenchmark, "Parkour benchmark has no runner class");
+		return;
+	}
+	SpawnRunners();
+	Frames.Reserve(BenchmarkFrames);
+	LOG_INFO(LogParkourBenchmark, "Parkour benchmark: %d runners, %d warmup + %d frames, simulation %s",
+		Runners.Num(), WarmupFrames, BenchmarkFrames, bUseParkourSimulation ? TEXT("on") : TEXT("off"));
+}
+
+void AParkourBenchmarkGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FParkourBenchmarkStats::StopRecording();
+	FApp::SetUseFixedTimeStep(bWasFixedTimeStep);
+	FApp::SetFixedDeltaTime(PreviousFixedDeltaTime);
+	Super::EndPlay(EndPlayReason);
+}
+
+void AParkourBenchmarkGameMode::Tick(const float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+	if (bFinished || Runners.IsEmpty())
+		return;
+
+	// Counters cover everything since the previous game mode tick, i.e. one full frame
+	if (CurrentFrame == WarmupFrames)
+		StartRecording();
+	else if (CurrentFrame > WarmupFrames)
+		RecordFrame();
+
+	if (Frames.Num() >= BenchmarkFrames)
+	{
+		Finish();
+		return;
+	}
+
+	for (int32 i = 0; i < Runners.Num(); i++)
+		DriveRunner(Runners[i], (CurrentFrame + i * RunnerStagger) % ScriptLength);
+	CurrentFrame++;
+}
+
+void AParkourBenchmarkGameMode::SpawnRunners()
+{
+	FTransform Origin = FTransform::Identity;
+	for (TActorIterator<APlayerStart> It(GetWorld()); It; ++It)
+	{
+		Origin = It->GetActorTransform();
+		break;
+	}
+
+	const int32 Side = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumRunners)));
+	const float HalfExtent = (Side - 1) * RunnerSpacing * 0.5f;
+	FRandomStream Stream(RandomSeed);
+
+	Runners.Reserve(NumRunners);
+	for (int32 i = 0; i < NumRunners; i++)
+	{
+		const FVector Offset((i % Side) * RunnerSpacing - HalfExtent, (i / Side) * RunnerSpacing - HalfExtent, 0.f);
+		const FRotator Rotation(0.f, Origin.Rotator().Yaw + Stream.RandRange(0, 3) * 90.f, 0.f);
+		const FTransform Transform(Rotation, Origin.TransformPosition(Offset));
+
+		AVSlicesCharacter* Character = GetWorld()->SpawnActorDeferred<AVSlicesCharacter>(
+			RunnerClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+		if (!Character)
+			continue;
+
+		Character->SetUseParkourSimulation(bUseParkourSimulation);
+		Character->FinishSpawning(Transform);
+		Character->SpawnDefaultController();
+		if (AController* Controller = Character->GetController())
+			Controller->SetControlRotation(Rotation);
+
+		FRunner& Runner = Runners.AddDefaulted_GetRef();
+		Runner.Character = Character;
+	}
+}
+
+void AParkourBenchmarkGameMode::DriveRunner(FRunner& Runner, const int32 ScriptFrame) const
+{
+	if (!Runner.Character.IsValid())
+		return;
+
+	for (const FParkourBenchmarkStep& Step : Script)
+	{
+		if (Step.Frame == ScriptFrame)
+			ApplyAction(Runner, Step.Action);
+	}
+	if (Runner.bMoving)
+		Runner.Character->Move(FInputActionValue(FVector2D(0.f, 1.f)));
+}
+
+void AParkourBenchmarkGameMode::ApplyAction(FRunner& Runner, const EParkourBenchmarkAction Action)
+{
+	AVSlicesCharacter* Character = Runner.Character.Get();
+	switch (Action)
+	{
+	case EParkourBenchmarkAction::MoveForward: Runner.bMoving = true; break;
+	case EParkourBenchmarkAction::StopMoving:  Runner.bMoving = false; break;
+	case EParkourBenchmarkAction::Sprint:      Character->StartSprinting(); break;
+	case EParkourBenchmarkAction::StopSprint:  Character->StopSprinting(); break;
+	case EParkourBenchmarkAction::Crouch:      Character->StartCrouch(); break;
+	case EParkourBenchmarkAction::StopCrouch:  Character->StopCrouch(); break;
+	case EParkourBenchmarkAction::Jump:        Character->Jump(); break;
+	case EParkourBenchmarkAction::StopJump:    Character->StopJumping(); break;
+	case EParkourBenchmarkAction::Grapple:     Character->ShootGrapplingHook(); break;
+	}
+}
+
+#pragma region REPORT
+
+void AParkourBenchmarkGameMode::StartRecording()
+{
+	FParkourBenchmarkStats::StartRecording();
+	StartUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	LastFrameTime = FPlatformTime::Seconds();
+}
+
+void AParkourBenchmarkGameMode::RecordFrame()
+{
+	const double Now = FPlatformTime::Seconds();
+	FBenchmarkFrame& Frame = Frames.AddDefaulted_GetRef();
+	Frame.FrameSeconds = Now - LastFrameTime;
+	Frame.UsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	for (int32 Channel = 0; Channel < FParkourBenchmarkStats::NumChannels; Channel++)
+	{
+		Frame.TickCycles[Channel] = FParkourBenchmarkStats::GetTickCycles(static_cast<EParkourSimChannel>(Channel));
+		Frame.Queries[Channel] = FParkourBenchmarkStats::GetQueryCount(static_cast<EParkourSimChannel>(Channel));
+	}
+	FParkourBenchmarkStats::Reset();
+	LastFrameTime = Now;
+}
+
+void AParkourBenchmarkGameMode::Finish()
+{
+	bFinished = true;
+	FParkourBenchmarkStats::StopRecording();
+	WriteReport();
+
+	// CI runs are unattended and only need the report
+	if (FApp::IsUnattended())
+		FPlatformMisc::RequestExit(false, TEXT("ParkourBenchmark"));
+}
+
+FString AParkourBenchmarkGameMode::GetReportPath(const TCHAR* Extension) const
+{
+	if (FPaths::IsRelative(ReportName))
+		return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"), ReportName + Extension);
+	return ReportName + Extension;
+}
+
+void AParkourBenchmarkGameMode::WriteReport() const
+{
+	constexpr int32 NumChannels = FParkourBenchmarkStats::NumChannels;
+	const double MsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1000.0;
+
+	// Per-frame CSV
+	FString Csv = TEXT("Frame,FrameMs,UsedPhysicalMB");
+	for (int32 Channel = 0; Channel < NumChannels; Channel++)
+	{
+		const TCHAR* Name = FParkourBenchmarkStats::GetChannelName(static_cast<EParkourSimChannel>(Channel));
+		Csv += FString::Printf(TEXT(",%sMs,%sQueries"), Name, Name);
+	}
+	Csv += LINE_TERMINATOR;
+
+	double TotalChannelMs[NumChannels] = {};
+	int64 TotalQueries[NumChannels] = {};
+	TArray<double> FrameMs;
+	FrameMs.Reserve(Frames.Num());
+	for (int32 i = 0; i < Frames.Num(); i++)
+	{
+		const FBenchmarkFrame& Frame = Frames[i];
+		FrameMs.Add(Frame.FrameSeconds * 1000.0);
+		Csv += FString::Printf(TEXT("%d,%.4f,%.2f"), i, FrameMs.Last(), Frame.UsedPhysical / (1024.0 * 1024.0));
+		for (int32 Channel = 0; Channel < NumChannels; Channel++)
+		{
+			const double ChannelMs = Frame.TickCycles[Channel] * MsPerCycle;
+			TotalChannelMs[Channel] += ChannelMs;
+			TotalQueries[Channel] += Frame.Queries[Channel];
+			Csv += FString::Printf(TEXT(",%.4f,%d"), ChannelMs, Frame.Queries[Channel]);
+		}
+		Csv += LINE_TERMINATOR;
+	}
+
+	// Summary JSON
+	FrameMs.Sort();
+	const int32 NumFrames = FMath::Max(Frames.Num(), 1);
+	auto Percentile = [&FrameMs](const double P)
+	{
+		return FrameMs.IsEmpty() ? 0.0 : FrameMs[FMath::Min(FMath::FloorToInt(P * FrameMs.Num()), FrameMs.Num() - 1)];
+	};
+	double TotalFrameMs = 0.0;
+	for (const double Ms : FrameMs)
+		TotalFrameMs += Ms;
+	const int64 EndUsedPhysical = Frames.IsEmpty() ? StartUsedPhysical : Frames.Last().UsedPhysical;
+
+	FString Json = TEXT("{") LINE_TERMINATOR;
+	Json += FString::Printf(TEXT("\t\"runners\": %d,") LINE_TERMINATOR, Runners.Num());
+	Json += FString::Printf(TEXT("\t\"frames\": %d,") LINE_TERMINATOR, Frames.Num());
+	Json += FString::Printf(TEXT("\t\"fixedDeltaTime\": %f,") LINE_TERMINATOR, FixedDeltaTime);
+	Json += FString::Printf(TEXT("\t\"simulation\": %s,") LINE_TERMINATOR, bUseParkourSimulation ? TEXT("true") : TEXT("false"));
+	Json += FString::Printf(TEXT("\t\"seed\": %d,") LINE_TERMINATOR, RandomSeed);
+	Json += FString::Printf(TEXT("\t\"frameMs\": { \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f },") LINE_TERMINATOR,
+		TotalFrameMs / NumFrames, Percentile(0.5), Percentile(0.95), Percentile(0.99), FrameMs.IsEmpty() ? 0.0 : FrameMs.Last());
+	Json += FString::Printf(TEXT("\t\"usedPhysicalDeltaMB\": %.2f,") LINE_TERMINATOR,
+		(EndUsedPhysical - static_cast<int64>(StartUsedPhysical)) / (1024.0 * 1024.0));
+	Json += TEXT("\t\"components\": {") LINE_TERMINATOR;
+	for (int32 Channel = 0; Channel < NumChannels; Channel++)
+	{
+		Json += FString::Printf(TEXT("\t\t\"%s\": { \"totalMs\": %.4f, \"msPerFrame\": %.4f, \"queries\": %lld, \"queriesPerFrame\": %.2f }%s") LINE_TERMINATOR,
+			FParkourBenchmarkStats::GetChannelName(static_cast<EParkourSimChannel>(Channel)),
+			TotalChannelMs[Channel], TotalChannelMs[Channel] / NumFrames,
+			TotalQueries[Channel], static_cast<double>(TotalQueries[Channel]) / NumFrames,
+			Channel + 1 < NumChannels ? TEXT(",") : TEXT(""));
+	}
+	Json += TEXT("\t}") LINE_TERMINATOR TEXT("}") LINE_TERMINATOR;
+
+	const FString CsvPath = GetReportPath(TEXT(".csv"));
+	const FString JsonPath = GetReportPath(TEXT(".json"));
+	if (!FFileHelper::SaveStringToFile(Csv, *CsvPath) || !FFileHelper::SaveStringToFile(Json, *JsonPath))
+	{
+		LOG_ERROR(LogParkourBenchmark, "Failed to write parkour benchmark report to %s", *CsvPath);
+		return;
+	}
+	LOG_INFO(LogParkourBenchmark, "Parkour benchmark: mean %.3f ms, p95 %.3f ms over %d frames, report in %s",
+		TotalFrameMs / NumFrames, Percentile(0.95), Frames.Num(), *JsonPath);
+}
+
+#pragma endregion REPORT
@@ -0,0 +1,133 @@
+#include "ParkourStats.h"
+#include "Characters/VSlicesCharacter.h"
+#include "Characters/Components/ParkourComponentBase.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_STAT(STAT_ParkourVaultTick);
+DEFINE_STAT(STAT_ParkourWallRunTick);
+DEFINE_STAT(STAT_ParkourGrappleTick);
+DEFINE_STAT(STAT_ParkourLedgeSwingTick);
+
+DEFINE_STAT(STAT_ParkourVaultQuery);
+DEFINE_STAT(STAT_ParkourWallRunQuery);
+DEFINE_STAT(STAT_ParkourGrappleQuery);
+DEFINE_STAT(STAT_ParkourLedgeSwingQuery);
+
+DEFINE_STAT(STAT_ParkourVaultQueries);
+DEFINE_STAT(STAT_ParkourWallRunQueries);
+DEFINE_STAT(STAT_ParkourGrappleQueries);
+DEFINE_STAT(STAT_ParkourLedgeSwingQueries);
+
+DEFINE_STAT(STAT_ParkourSimulationCompute);
+DEFINE_STAT(STAT_ParkourSimulationApply);
+
+TStatId GetParkourTickStatId(const EParkourSimChannel Channel)
+{
+	switch (Channel)
+	{
+	case EParkourSimChannel::Vault:      return GET_STATID(STAT_ParkourVaultTick);
+	case EParkourSimChannel::WallRun:    return GET_STATID(STAT_ParkourWallRunTick);
+	case EParkourSimChannel::Grapple:    return GET_STATID(STAT_ParkourGrappleTick);
+	case EParkourSimChannel::LedgeSwing: return GET_STATID(STAT_ParkourLedgeSwingTick);
+	default:                             return TStatId();
+	}
+}
+
+bool FParkourBenchmarkStats::bRecording = false;
+int64 FParkourBenchmarkStats::TickCycles[NumChannels] = {};
+int32 FParkourBenchmarkStats::QueryCounts[NumChannels] = {};
+
+void FParkourBenchmarkStats::StartRecording()
+{
+	Reset();
+	bRecording = true;
+}
+
+void FParkourBenchmarkStats::StopRecording()
+{
+	bRecording = false;
+}
+
+void FParkourBenchmarkStats::Reset()
+{
+	for (int32 Channel = 0; Channel < NumChannels; Channel++)
+	{
+		FPlatformAtomics::InterlockedExchange(&TickCycles[Channel], 0);
+		FPlatformAtomics::InterlockedExchange(&QueryCounts[Channel], 0);
+	}
+}
+
+void FParkourBenchmarkStats::AddTickCycles(const EParkourSimChannel Channel, const uint64 Cycles)
+{
+	if (!bRecording || Channel == EParkourSimChannel::None)
+		return;
+	FPlatformAtomics::InterlockedAdd(&TickCycles[static_cast<int32>(Channel)], static_cast<int64>(Cycles));
+}
+
+void FParkourBenchmarkStats::AddQuery(const EParkourSimChannel Channel)
+{
+	if (!bRecording || Channel == EParkourSimChannel::None)
+		return;
+	FPlatformAtomics::InterlockedIncrement(&QueryCounts[static_cast<int32>(Channel)]);
+}
+
+uint64 FParkourBenchmarkStats::GetTickCycles(const EParkourSimChannel Channel)
+{
+	return static_cast<uint64>(FPlatformAtomics::AtomicRead(&TickCycles[static_cast<int32>(Channel)]));
+}
+
+int32 FParkourBenchmarkStats::GetQueryCount(const EParkourSimChannel Channel)
+{
+	return FPlatformAtomics::AtomicRead(&QueryCounts[static_cast<int32>(Channel)]);
+}
+
+const TCHAR* FParkourBenchmarkStats::GetChannelName(const EParkourSimChannel Channel)
+{
+	switch (Channel)
+	{
+	case EParkourSimChannel::Vault:      return TEXT("Vault");
+	case EParkourSimChannel::WallRun:    return TEXT("WallRun");
+	case EParkourSimChannel::Grapple:    return TEXT("Grapple");
+	case EParkourSimChannel::LedgeSwing: return TEXT("LedgeSwing");
+	default:                             return TEXT("None");
+	}
+}
+
+// Parkour.DumpQueryBudget [reset]
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice DumpQueryBudgetCommand(
+	TEXT("Parkour.DumpQueryBudget"),
+	TEXT("Prints physics queries per character and component: latest active frame, peak, budget, frames over budget, total and rate. Pass 'reset' to clear."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		if (!World)
+			return;
+		
+		const bool bReset = Args.Num() > 0 && Args[0].Equals(TEXT("reset"), ESearchCase::IgnoreCase);
+		const double Now = World->GetTimeSeconds();
+		
+		for (TActorIterator<AVSlicesCharacter> It(World); It; ++It)
+		{
+			TInlineComponentArray<UParkourComponentBase*> Components(*It);
+			int32 CharacterLatest = 0;
+			int32 CharacterTotal = 0;
+			Ar.Logf(TEXT("%s"), *It->GetName());
+			
+			for (UParkourComponentBase* Component : Components)
+			{
+				const FParkourQueryBudget& Budget = Component->GetQueryBudget();
+				const double Elapsed = FMath::Max(Now - Budget.StartTime, UE_SMALL_NUMBER);
+				const int32 Limit = Component->GetQueryBudgetPerFrame();
+				Ar.Logf(TEXT("  %-24s latest %3d  peak %3d  budget %3s  over %5d  total %7d  %.1f/s"),
+					*Component->GetName(), Budget.FrameQueries, Budget.Peak,
+					Limit > 0 ? *FString::FromInt(Limit) : TEXT("-"), Budget.OverBudgetFrames,
+					Budget.Total, Budget.Total / Elapsed);
+				
+				CharacterLatest += Budget.FrameQueries;
+				CharacterTotal += Budget.Total;
+				if (bReset)
+					Component->ResetQueryBudget();
+			}
+			Ar.Logf(TEXT("  %-24s latest %3d  total %7d"), TEXT("(all)"), CharacterLatest, CharacterTotal);
+		}
+	}));
@@ -0,0 +1,149 @@
+#include "Subsystems/GrapplePointSubsystem.h"
+#include "Subsystems/ParkourAffordanceSubsystem.h"
+#include "Data/ParkourAffordanceIndex.h"
+#include "EngineUtils.h"
+#include "LoggingMacros.h"
+
+const FName UGrapplePointSubsystem::AnchorTag(TEXT("GrapplePoint"));
+
+void UGrapplePointSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+	
+	for (TActorIterator<AActor> It(&InWorld); It; ++It)
+	{
+		if (It->ActorHasTag(AnchorTag))
+			Anchors.Add(*It);
+	}
+	bDirty = true;
+}
+
+void UGrapplePointSubsystem::Deinitialize()
+{
+	Anchors.Reset();
+	Points.Reset();
+	Cells.Reset();
+	Super::Deinitialize();
+}
+
+bool UGrapplePointSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UGrapplePointSubsystem::RegisterAnchor(AActor* Anchor)
+{
+	if (!Anchor) return;
+	Anchors.AddUnique(Anchor);
+	bDirty = true;
+}
+
+void UGrapplePointSubsystem::UnregisterAnchor(AActor* Anchor)
+{
+	if (Anchors.Remove(Anchor) > 0)
+		bDirty = true;
+}
+
+void UGrapplePointSubsystem::Rebuild() const
+{
+	bDirty = false;
+	Points.Reset();
+	Cells.Reset();
+	
+	for (const TWeakObjectPtr<AActor>& Anchor : Anchors)
+	{
+		if (Anchor.IsValid())
+			AddPoint(Anchor->GetActorLocation());
+	}
+	NumAnchorPoints = Points.Num();
+	
+	// The affordance index loads in its own OnWorldBeginPlay, so it is read here rather than at BeginPlay
+	const UParkourAffordanceSubsystem* Affordances = GetWorld()->GetSubsystem<UParkourAffordanceSubsystem>();
+	if (const UParkourAffordanceIndex* Index = Affordances ? Affordances->GetIndex() : nullptr)
+	{
+		for (const FParkourWallTop& Top : Index->WallTops)
+		{
+			if (Top.TopZ - Top.BottomZ < MinLedgeWallHeight)
+				continue;
+			
+			const FVector2f Perp(-Top.Axis.Y, Top.Axis.X);
+			const FVector2f Corners[4] = {
+				Top.Center - Top.Axis * Top.HalfExtents.X - Perp * Top.HalfExtents.Y,
+				Top.Center + Top.Axis * Top.HalfExtents.X - Perp * Top.HalfExtents.Y,
+				Top.Center + Top.Axis * Top.HalfExtents.X + Perp * Top.HalfExtents.Y,
+				Top.Center - Top.Axis * Top.HalfExtents.X + Perp * Top.HalfExtents.Y };
+			for (int32 Edge = 0; Edge < 4; Edge++)
+			{
+				const FVector2f& EdgeStart = Corners[Edge];
+				const FVector2f& EdgeEnd = Corners[(Edge + 1) % 4];
+				const int32 NumSegments = FMath::Max(1, FMath::CeilToInt(FVector2f::Distance(EdgeStart, EdgeEnd) / LedgePointSpacing));
+				for (int32 Segment = 0; Segment < NumSegments; Segment++)
+				{
+					const FVector2f Point = FMath::Lerp(EdgeStart, EdgeEnd, (Segment + 0.5f) / NumSegments);
+					AddPoint(FVector(Point.X, Point.Y, Top.TopZ));
+				}
+			}
+		}
+	}
+	LOG_VERBOSE(LogParkourGrapple, "Grapple index rebuilt: %d anchors, %d ledge points", NumAnchorPoints, Points.Num() - NumAnchorPoints);
+}
+
+void UGrapplePointSubsystem::AddPoint(const FVector& Location) const
+{
+	Cells.FindOrAdd(ToCell(FVector2D(Location))).Add(Points.Add(Location));
+}
+
+FIntPoint UGrapplePointSubsystem::ToCell(const FVector2D& Location)
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+bool UGrapplePointSubsystem::FindBestCandidate(const FGrapplePointQuery& Query, FVector& OutLocation) const
+{
+	if (bDirty)
+		Rebuild();
+	if (Points.IsEmpty())
+		return false;
+	
+	const FVector2D Origin(Query.Origin);
+	const FIntPoint MinCell = ToCell(Origin - FVector2D(Query.Range));
+	const FIntPoint MaxCell = ToCell(Origin + FVector2D(Query.Range));
+	const float RangeSquared = FMath::Square(Query.Range);
+	const float MinDistSquared = FMath::Square(Query.MinDistance);
+	const float MinLedgeZ = Query.Origin.Z + Query.MinLedgeHeight;
+	const float ConeWidth = FMath::Max(1.f - Query.CosConeAngle, UE_KINDA_SMALL_NUMBER);
+	
+	float BestScore = TNumericLimits<float>::Max();
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			const TArray<int32>* Cell = Cells.Find(FIntPoint(X, Y));
+			if (!Cell) continue;
+			
+			for (const int32 i : *Cell)
+			{
+				const FVector ToPoint = Points[i] - Query.Origin;
+				const float DistSquared = ToPoint.SizeSquared();
+				const float Along = ToPoint | Query.Direction;
+				if (DistSquared > RangeSquared || DistSquared < MinDistSquared || Along <= 0.f)
+					continue;
+				if (i >= NumAnchorPoints && Points[i].Z < MinLedgeZ)
+					continue;
+				
+				// Cone test without a sqrt: cos^2 compared against the cone's cos^2, both sides positive
+				if (FMath::Square(Along) < FMath::Square(Query.CosConeAngle) * DistSquared)
+					continue;
+				
+				const float Dist = FMath::Sqrt(DistSquared);
+				const float Score = Query.AngleWeight * (1.f - Along / Dist) / ConeWidth + Query.DistanceWeight * Dist / Query.Range;
+				if (Score < BestScore)
+				{
+					BestScore = Score;
+					OutLocation = Points[i];
+				}
+			}
+		}
+	}
+	return BestScore < TNumericLimits<float>::Max();
+}
@@ -0,0 +1,209 @@
+#include "Subsystems/ParkourAffordanceSubsystem.h"
+#include "Data/ParkourAffordanceIndex.h"
+#include "LoggingMacros.h"
+
+void UParkourAffordanceSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+	
+	const FString MapName = FPackageName::GetShortName(UWorld::RemovePIEPrefix(InWorld.GetOutermost()->GetName()));
+	const FString PackageName = UParkourAffordanceIndex::GetPackageNameForMap(MapName);
+	const FString ObjectPath = PackageName + TEXT(".") + FPackageName::GetShortName(PackageName);
+	
+	Index = LoadObject<UParkourAffordanceIndex>(nullptr, *ObjectPath, nullptr, LOAD_NoWarn | LOAD_Quiet);
+	if (!Index)
+	{
+		LOG_INFO(LogParkourWorld, "No affordance index for %s, parkour detection will trace", *MapName);
+		return;
+	}
+	BuildCells();
+	LOG_INFO(LogParkourWorld, "Loaded affordance index for %s: %d wall tops, %d poles", *MapName, Index->WallTops.Num(), Index->Poles.Num());
+}
+
+void UParkourAffordanceSubsystem::Deinitialize()
+{
+	Cells.Reset();
+	Index = nullptr;
+	Super::Deinitialize();
+}
+
+bool UParkourAffordanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UParkourAffordanceSubsystem::BuildCells()
+{
+	Cells.Reset();
+	
+	auto AddToCells = [this](const FVector2D& Min, const FVector2D& Max, TFunctionRef<void(FCell&)> Add)
+	{
+		const FIntPoint MinCell = ToCell(Min);
+		const FIntPoint MaxCell = ToCell(Max);
+		for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+				Add(Cells.FindOrAdd(FIntPoint(X, Y)));
+	};
+	
+	for (int32 i = 0; i < Index->WallTops.Num(); i++)
+	{
+		const FParkourWallTop& Top = Index->WallTops[i];
+		const FVector2f Perp(-Top.Axis.Y, Top.Axis.X);
+		const FVector2f Reach = (Top.Axis * Top.HalfExtents.X).GetAbs() + (Perp * Top.HalfExtents.Y).GetAbs();
+		AddToCells(FVector2D(Top.Center - Reach), FVector2D(Top.Center + Reach), [i](FCell& Cell) { Cell.WallTops.Add(i); });
+	}
+	for (int32 i = 0; i < Index->Poles.Num(); i++)
+	{
+		const FParkourPoleAxis& Pole = Index->Poles[i];
+		const FVector2D Min(FMath::Min(Pole.Start.X, Pole.End.X) - Pole.Radius, FMath::Min(Pole.Start.Y, Pole.End.Y) - Pole.Radius);
+		const FVector2D Max(FMath::Max(Pole.Start.X, Pole.End.X) + Pole.Radius, FMath::Max(Pole.Start.Y, Pole.End.Y) + Pole.Radius);
+		AddToCells(Min, Max, [i](FCell& Cell) { Cell.Poles.Add(i); });
+	}
+	for (const FParkourOpaqueVolume& Volume : Index->OpaqueVolumes)
+		AddToCells(FVector2D(Volume.Min.X, Volume.Min.Y), FVector2D(Volume.Max.X, Volume.Max.Y), [](FCell& Cell) { Cell.bOpaque = true; });
+}
+
+void UParkourAffordanceSubsystem::GatherCells(const FVector2D& Min, const FVector2D& Max, TArray<const FCell*>& OutCells, bool& bOutCovered) const
+{
+	// Covered only if every cell was baked and none holds geometry the bake could not describe
+	bOutCovered = true;
+	const FIntPoint MinCell = ToCell(Min);
+	const FIntPoint MaxCell = ToCell(Max);
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			const FCell* Cell = Cells.Find(FIntPoint(X, Y));
+			bOutCovered &= Cell && !Cell->bOpaque;
+			if (Cell)
+				OutCells.Add(Cell);
+		}
+	}
+}
+
+FIntPoint UParkourAffordanceSubsystem::ToCell(const FVector2D& Location)
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+EParkourAffordanceQuery UParkourAffordanceSubsystem::FindWallTop(const FVector& Start, const float EndZ, float& OutTopZ) const
+{
+	if (!Index) return EParkourAffordanceQuery::Unknown;
+	
+	const FVector2D Point(Start);
+	const FCell* Cell = Cells.Find(ToCell(Point));
+	if (!Cell || Cell->bOpaque) return EParkourAffordanceQuery::Unknown;
+	
+	bool bFound = false;
+	OutTopZ = EndZ;
+	for (const int32 i : Cell->WallTops)
+	{
+		const FParkourWallTop& Top = Index->WallTops[i];
+		const FVector2f Local = FVector2f(Point) - Top.Center;
+		const FVector2f Perp(-Top.Axis.Y, Top.Axis.X);
+		if (FMath::Abs(Local | Top.Axis) > Top.HalfExtents.X || FMath::Abs(Local | Perp) > Top.HalfExtents.Y)
+			continue;
+		if (Top.TopZ > Start.Z || Top.TopZ < OutTopZ)
+			continue;
+		OutTopZ = Top.TopZ;
+		bFound = true;
+	}
+	return bFound ? EParkourAffordanceQuery::Found : EParkourAffordanceQuery::None;
+}
+
+EParkourAffordanceQuery UParkourAffordanceSubsystem::FindLedge(const FVector& Start, const FVector& Direction, const float Reach,
+	const float MinTopZ, const float MaxTopZ, FVector& OutLocation) const
+{
+	if (!Index) return EParkourAffordanceQuery::Unknown;
+	
+	const FVector2D Origin(Start);
+	const FVector2D End = Origin + FVector2D(Direction) * Reach;
+	
+	TArray<const FCell*> Candidates;
+	bool bCovered;
+	GatherCells(FVector2D::Min(Origin, End), FVector2D::Max(Origin, End), Candidates, bCovered);
+	if (!bCovered) return EParkourAffordanceQuery::Unknown;
+	
+	float BestT = Reach;
+	bool bFound = false;
+	const FVector2f RayOrigin(Origin);
+	const FVector2f RayDir(FVector2D(Direction));
+	for (const FCell* Cell : Candidates)
+	{
+		for (const int32 i : Cell->WallTops)
+		{
+			const FParkourWallTop& Top = Index->WallTops[i];
+			if (Start.Z < Top.BottomZ || Start.Z > Top.TopZ || Top.TopZ < MinTopZ || Top.TopZ > MaxTopZ)
+				continue;
+			
+			// Slab test in footprint space
+			const FVector2f Perp(-Top.Axis.Y, Top.Axis.X);
+			const FVector2f LocalOrigin((RayOrigin - Top.Center) | Top.Axis, (RayOrigin - Top.Center) | Perp);
+			const FVector2f LocalDir(RayDir | Top.Axis, RayDir | Perp);
+			float TMin = 0.f;
+			float TMax = BestT;
+			bool bHit = true;
+			for (int32 Axis = 0; Axis < 2 && bHit; Axis++)
+			{
+				if (FMath::IsNearlyZero(LocalDir[Axis]))
+				{
+					bHit = FMath::Abs(LocalOrigin[Axis]) <= Top.HalfExtents[Axis];
+					continue;
+				}
+				float T0 = (-Top.HalfExtents[Axis] - LocalOrigin[Axis]) / LocalDir[Axis];
+				float T1 = (Top.HalfExtents[Axis] - LocalOrigin[Axis]) / LocalDir[Axis];
+				if (T0 > T1) Swap(T0, T1);
+				TMin = FMath::Max(TMin, T0);
+				TMax = FMath::Min(TMax, T1);
+				bHit = TMin <= TMax;
+			}
+			// Starting inside the footprint is not a ledge in front of us
+			if (!bHit || TMin <= 0.f)
+				continue;
+			
+			BestT = TMin;
+			bFound = true;
+			const FVector2D HitPoint = Origin + FVector2D(Direction) * TMin;
+			OutLocation = FVector(HitPoint.X, HitPoint.Y, Top.TopZ);
+		}
+	}
+	return bFound ? EParkourAffordanceQuery::Found : EParkourAffordanceQuery::None;
+}
+
+EParkourAffordanceQuery UParkourAffordanceSubsystem::FindPole(const FVector& Start, const float MinZ, const float MaxZ,
+	FVector& OutLocation, FVector& OutNormal) const
+{
+	if (!Index) return EParkourAffordanceQuery::Unknown;
+	
+	const FVector2D Point(Start);
+	const FCell* Cell = Cells.Find(ToCell(Point));
+	if (!Cell || Cell->bOpaque) return EParkourAffordanceQuery::Unknown;
+	
+	float BestZ = MaxZ;
+	bool bFound = false;
+	for (const int32 i : Cell->Poles)
+	{
+		const FParkourPoleAxis& Pole = Index->Poles[i];
+		const FVector AxisStart(Pole.Start);
+		const FVector AxisEnd(Pole.End);
+		const FVector2D Closest2D = FMath::ClosestPointOnSegment2D(Point, FVector2D(AxisStart), FVector2D(AxisEnd));
+		if (FVector2D::DistSquared(Point, Closest2D) > FMath::Square(Pole.Radius))
+			continue;
+		
+		const FVector OnAxis = FMath::ClosestPointOnSegment(FVector(Closest2D, Start.Z), AxisStart, AxisEnd);
+		const float UndersideZ = OnAxis.Z - Pole.Radius;
+		if (UndersideZ < MinZ || UndersideZ > BestZ)
+			continue;
+		
+		BestZ = UndersideZ;
+		bFound = true;
+		OutLocation = FVector(OnAxis.X, OnAxis.Y, UndersideZ);
+		
+		// Side normal facing the runner
+		const FVector AxisDir = (AxisEnd - AxisStart).GetSafeNormal2D();
+		OutNormal = FVector(-AxisDir.Y, AxisDir.X, 0.f);
+		if ((OutNormal | (Start - OnAxis)) < 0.f)
+			OutNormal = -OutNormal;
+	}
+	return bFound ? EParkourAffordanceQuery::Found : EParkourAffordanceQuery::None;
+}
@@ -0,0 +1,185 @@
+#include "Subsystems/ParkourSimulationSubsystem.h"
+#include "Characters/Components/ParkourComponentBase.h"
+#include "Characters/VSlicesCharacter.h"
+#include "Async/ParallelFor.h"
+#include "ParkourStats.h"
+
+FParkourRunnerState FParkourRunnerState::Capture(const ACharacter* Character)
+{
+	FParkourRunnerState State;
+	State.Location = Character->GetActorLocation();
+	State.Velocity = Character->GetVelocity();
+	State.Rotation = Character->GetActorRotation();
+	return State;
+}
+
+void UParkourSimulationSubsystem::Tick(const float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	RemoveStaleSlots();
+	
+	// Gather: one read of each active runner
+	RunnerStates.SetNum(Runners.Num());
+	for (int32 Slot = 0; Slot < Runners.Num(); Slot++)
+	{
+		if (ActiveMasks[Slot])
+			RunnerStates[Slot] = FParkourRunnerState::Capture(Runners[Slot].Get());
+	}
+	
+	// Channel-major so each pass walks one contiguous column
+	Steps.Reset();
+	for (int32 Channel = 0; Channel < NumChannels; Channel++)
+	{
+		const uint8 Bit = 1 << Channel;
+		const TArray<TWeakObjectPtr<UParkourComponentBase>>& Column = Components[Channel];
+		TArray<float>& Accumulator = Accumulators[Channel];
+		const TArray<float>& ColumnIntervals = Intervals[Channel];
+		
+		for (int32 Slot = 0; Slot < Runners.Num(); Slot++)
+		{
+			UParkourComponentBase* Component = ActiveMasks[Slot] & Bit ? Column[Slot].Get() : nullptr;
+			if (!Component)
+				continue;
+			
+			Accumulator[Slot] += DeltaTime;
+			if (Accumulator[Slot] < ColumnIntervals[Slot])
+				continue;
+			
+			Steps.Add({Component, Accumulator[Slot], Slot, static_cast<EParkourSimChannel>(Channel)});
+			Accumulator[Slot] = 0.f;
+		}
+	}
+	
+	// Compute: math only, no actor or world access
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ParkourSimulationCompute);
+		ParallelFor(TEXT("ParkourSimulation"), Steps.Num(), MinParallelBatchSize, [this](const int32 Index)
+		{
+			const FParkourSimStep& Step = Steps[Index];
+			PARKOUR_TICK_SCOPE(Step.Channel);
+			Step.Component->ComputeTick(Step.DeltaTime, RunnerStates[Step.Slot]);
+		});
+	}
+	
+	// Apply: actor writes stay on the game thread
+	SCOPE_CYCLE_COUNTER(STAT_ParkourSimulationApply);
+	for (const FParkourSimStep& Step : Steps)
+	{
+		if (!IsValid(Step.Component))
+			continue;
+		PARKOUR_TICK_SCOPE(Step.Channel);
+		Step.Component->ApplyTick(Step.DeltaTime);
+	}
+}
+
+TStatId UParkourSimulationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UParkourSimulationSubsystem, STATGROUP_Tickables);
+}
+
+void UParkourSimulationSubsystem::Deinitialize()
+{
+	Runners.Reset();
+	ActiveMasks.Reset();
+	RunnerStates.Reset();
+	Steps.Reset();
+	for (int32 Channel = 0; Channel < NumChannels; Channel++)
+	{
+		Components[Channel].Reset();
+		Accumulators[Channel].Reset();
+		Intervals[Channel].Reset();
+	}
+	SlotLookup.Reset();
+	Super::Deinitialize();
+}
+
+void UParkourSimulationSubsystem::Register(UParkourComponentBase* Component, const EParkourSimChannel Channel)
+{
+	AVSlicesCharacter* Character = Cast<AVSlicesCharacter>(Component->GetOwner());
+	if (!Character || Channel == EParkourSimChannel::None)
+		return;
+	
+	const int32 Slot = FindOrAddSlot(Character);
+	const int32 Index = static_cast<int32>(Channel);
+	Components[Index][Slot] = Component;
+	Intervals[Index][Slot] = Component->GetComponentTickInterval();
+}
+
+void UParkourSimulationSubsystem::Unregister(UParkourComponentBase* Component, const EParkourSimChannel Channel)
+{
+	const int32* Slot = SlotLookup.Find(Cast<AVSlicesCharacter>(Component->GetOwner()));
+	if (!Slot || Channel == EParkourSimChannel::None)
+		return;
+	
+	const int32 Index = static_cast<int32>(Channel);
+	Components[Index][*Slot] = nullptr;
+	ActiveMasks[*Slot] &= ~(1 << Index);
+	
+	for (int32 i = 0; i < NumChannels; i++)
+	{
+		if (Components[i][*Slot].IsValid())
+			return;
+	}
+	RemoveSlot(*Slot);
+}
+
+void UParkourSimulationSubsystem::SetActive(const AVSlicesCharacter* Character, const EParkourSimChannel Channel, const bool bActive)
+{
+	const int32* Slot = SlotLookup.Find(Character);
+	if (!Slot || Channel == EParkourSimChannel::None)
+		return;
+	
+	const uint8 Bit = 1 << static_cast<int32>(Channel);
+	if (bActive)
+		ActiveMasks[*Slot] |= Bit;
+	else
+		ActiveMasks[*Slot] &= ~Bit;
+}
+
+int32 UParkourSimulationSubsystem::FindOrAddSlot(AVSlicesCharacter* Character)
+{
+	if (const int32* Slot = SlotLookup.Find(Character))
+		return *Slot;
+	
+	const int32 Slot = Runners.Add(Character);
+	ActiveMasks.Add(0);
+	for (int32 Channel = 0; Channel < NumChannels; Channel++)
+	{
+		Components[Channel].Add(nullptr);
+		Accumulators[Channel].Add(0.f);
+		Intervals[Channel].Add(0.f);
+	}
+	SlotLookup.Add(Character, Slot);
+	return Slot;
+}
+
+void UParkourSimulationSubsystem::RemoveStaleSlots()
+{
+	// Backwards, so the runner swapped into a removed slot has already been checked
+	for (int32 Slot = Runners.Num() - 1; Slot >= 0; Slot--)
+	{
+		bool bHasComponent = false;
+		for (int32 Channel = 0; Channel < NumChannels && !bHasComponent; Channel++)
+			bHasComponent = Components[Channel][Slot].IsValid();
+		if (!Runners[Slot].IsValid() || !bHasComponent)
+			RemoveSlot(Slot);
+	}
+}
+
+void UParkourSimulationSubsystem::RemoveSlot(const int32 Slot)
+{
+	// Swap the last runner into the hole to keep the arrays dense
+	const int32 Last = Runners.Num() - 1;
+	SlotLookup.Remove(Runners[Slot]);
+	if (Slot != Last)
+		SlotLookup.Add(Runners[Last], Slot);
+	
+	Runners.RemoveAtSwap(Slot);
+	ActiveMasks.RemoveAtSwap(Slot);
+	for (int32 Channel = 0; Channel < NumChannels; Channel++)
+	{
+		Components[Channel].RemoveAtSwap(Slot);
+		Accumulators[Channel].RemoveAtSwap(Slot);
+		Intervals[Channel].RemoveAtSwap(Slot);
+	}
+}
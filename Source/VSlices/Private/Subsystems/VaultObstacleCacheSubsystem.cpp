@@ -0,0 +1,95 @@
+#include "Subsystems/VaultObstacleCacheSubsystem.h"
+#include "Components/PrimitiveComponent.h"
+
+void UVaultObstacleCacheSubsystem::Deinitialize()
+{
+	Reset();
+	Super::Deinitialize();
+}
+
+bool UVaultObstacleCacheSubsystem::FindObstacle(const FHitResult& Hit, FVaultObstacleCacheEntry& OutEntry) const
+{
+	FVaultObstacleCacheKey Key;
+	if (!MakeKey(Hit, Key))
+		return false;
+	
+	if (const FVaultObstacleCacheEntry* Entry = Entries.Find(Key))
+	{
+		OutEntry = *Entry;
+		return true;
+	}
+	return false;
+}
+
+void UVaultObstacleCacheSubsystem::StoreObstacle(const FHitResult& Hit, const FVaultObstacleCacheEntry& Entry)
+{
+	FVaultObstacleCacheKey Key;
+	if (!MakeKey(Hit, Key))
+		return;
+	
+	if (Entries.Num() >= MaxEntries && !Entries.Contains(Key))
+		Reset();
+	
+	Entries.Add(Key, Entry);
+	WatchComponent(Hit.GetComponent());
+}
+
+void UVaultObstacleCacheSubsystem::InvalidateComponent(const UPrimitiveComponent* Component)
+{
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		const UPrimitiveComponent* EntryComponent = It.Key().Component.Get();
+		if (!EntryComponent || EntryComponent == Component)
+			It.RemoveCurrent();
+	}
+}
+
+bool UVaultObstacleCacheSubsystem::MakeKey(const FHitResult& Hit, FVaultObstacleCacheKey& OutKey)
+{
+	UPrimitiveComponent* Component = Hit.GetComponent();
+	if (!Component)
+		return false;
+	
+	OutKey.Component = Component;
+	OutKey.Cell = FIntVector(
+		FMath::FloorToInt(Hit.Location.X / CellSize),
+		FMath::FloorToInt(Hit.Location.Y / CellSize),
+		FMath::FloorToInt(Hit.Location.Z / CellSize));
+	OutKey.NormalCell = FIntVector(
+		FMath::RoundToInt(Hit.Normal.X * NormalResolution),
+		FMath::RoundToInt(Hit.Normal.Y * NormalResolution),
+		FMath::RoundToInt(Hit.Normal.Z * NormalResolution));
+	return true;
+}
+
+void UVaultObstacleCacheSubsystem::WatchComponent(UPrimitiveComponent* Component)
+{
+	if (!Component || WatchedComponents.Contains(Component))
+		return;
+	
+	const FDelegateHandle Handle = Component->TransformUpdated.AddUObject(this, &UVaultObstacleCacheSubsystem::OnComponentTransformUpdated);
+	WatchedComponents.Add(Component, Handle);
+}
+
+void UVaultObstacleCacheSubsystem::OnComponentTransformUpdated(USceneComponent* Component, EUpdateTransformFlags UpdateFlags, ETeleportType Teleport)
+{
+	InvalidateComponent(Cast<UPrimitiveComponent>(Component));
+	
+	// Re-watched on the next store
+	if (const FDelegateHandle* Handle = WatchedComponents.Find(Component))
+	{
+		Component->TransformUpdated.Remove(*Handle);
+		WatchedComponents.Remove(Component);
+	}
+}
+
+void UVaultObstacleCacheSubsystem::Reset()
+{
+	for (const auto& Pair : WatchedComponents)
+	{
+		if (USceneComponent* Component = Pair.Key.Get())
+			Component->TransformUpdated.Remove(Pair.Value);
+	}
+	WatchedComponents.Reset();
+	Entries.Reset();
+}
@@ -2,6 +2,16 @@
 
 #include "VSlices.h"
 #include "Modules/ModuleManager.h"
+#include "LoggingMacros.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, VSlices, "VSlices" );
- 
\ No newline at end of file
+
+DEFINE_LOG_CATEGORY(LogParkour);
+DEFINE_LOG_CATEGORY(LogParkourMovement);
+DEFINE_LOG_CATEGORY(LogParkourVault);
+DEFINE_LOG_CATEGORY(LogParkourWallRun);
+DEFINE_LOG_CATEGORY(LogParkourGrapple);
+DEFINE_LOG_CATEGORY(LogParkourLedge);
+DEFINE_LOG_CATEGORY(LogParkourWorld);
+DEFINE_LOG_CATEGORY(LogParkourBenchmark);
+DEFINE_LOG_CATEGORY(LogParkourInput);
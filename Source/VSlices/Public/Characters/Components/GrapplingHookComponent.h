@@ -2,8 +2,12 @@
 
 #include "CoreMinimal.h"
 #include "ParkourComponentBase.h"
+#include "Engine/NetSerialization.h"
+#include "WorldCollision.h"
 #include "GrapplingHookComponent.generated.h"
 
+class UGrapplePointSubsystem;
+
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class VSLICES_API UGrapplingHookComponent : public UParkourComponentBase
 {
@@ -11,7 +15,8 @@ class VSLICES_API UGrapplingHookComponent : public UParkourComponentBase
 
 public: 
     UGrapplingHookComponent();
-    void TryShoot();
+    // False while a grapple or its mantle is still running; a miss still counts as a shot
+    bool TryShoot();
     void ReleaseGrapple();
     void ClimbAtEnd();
     FORCEINLINE bool GetIsGrappling() const { return bIsGrappling; }
@@ -19,10 +24,24 @@ public:
     FORCEINLINE FVector& GetGrappleLocation() {return GrappleLocation;}
     UFUNCTION(BlueprintCallable, BlueprintPure, Category="Grappling")
     FORCEINLINE bool IsGrappling() const {return bIsGrappling;}
+    // -1..1: positive reels the rope in at ReelInSpeed, negative pays it out at ReelOutSpeed; zero returns to the
+    // attach default, a full reel in with bAutoReelIn
+    UFUNCTION(BlueprintCallable, Category="Grappling")
+    void SetReelInput(float Axis);
+    // Local player, once per frame: keeps the reachability preview current with at most one async trace in flight
+    void UpdateAimPreview();
+    // Whether a shot fired now would connect, as of the latest preview trace; for the reticle
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="Grappling")
+    FORCEINLINE bool IsGrappleTargetValid() const { return Preview.bValid && !bIsGrappling && !bIsMantling; }
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="Grappling")
+    FORCEINLINE FVector GetPreviewTarget() const { return Preview.Target; }
 
 protected:
     virtual void BeginPlay() override;
-    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+    virtual void ComputeTick(float DeltaTime, const FParkourRunnerState& State) override;
+    virtual void ApplyTick(float DeltaTime) override;
+    virtual EParkourSimChannel GetSimulationChannel() const override { return EParkourSimChannel::Grapple; }
+    virtual bool IsSimulationActive() const override { return bIsGrappling || bIsMantling; }
 
 private:
     //Sounds
@@ -43,55 +62,123 @@ private:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grappling", meta = (AllowPrivateAccess = "true"))
     float ClimbDistance = 800.0f;
 
-    // Force Parameters
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Forces", meta = (AllowPrivateAccess = "true"))
+    // Aim Assist: when the crosshair trace finds nothing, snap to indexed grapple points near the crosshair
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Aim Assist", meta = (AllowPrivateAccess = "true"))
+    bool bUseAimAssist = true;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Aim Assist", meta = (AllowPrivateAccess = "true", ClampMin = "0.0", ClampMax = "45.0"))
+    float AimAssistConeAngle = 10.0f;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Aim Assist", meta = (AllowPrivateAccess = "true"))
+    float AimAssistAngleWeight = 1.0f;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Aim Assist", meta = (AllowPrivateAccess = "true"))
+    float AimAssistDistanceWeight = 0.25f;
+    // The confirming trace may stop this close to the candidate and still count as a clear line
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Aim Assist", meta = (AllowPrivateAccess = "true"))
+    float AimAssistVisibilityTolerance = 50.0f;
+    // Targets closer than this are ignored, whether hit by the crosshair or picked by aim assist
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Aim Assist", meta = (AllowPrivateAccess = "true"))
+    float MinGrappleDistance = 300.0f;
+    // Ledge edges only count as aim-assist candidates this far above the view or higher
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Aim Assist", meta = (AllowPrivateAccess = "true"))
+    float AimAssistMinLedgeHeight = 0.0f;
+
+    // Preview: frames between async preview traces, and how far the view may drift before the last result is stale
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Preview", meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+    int32 PreviewTraceInterval = 3;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Preview", meta = (AllowPrivateAccess = "true"))
+    float PreviewReuseDistance = 10.0f;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Preview", meta = (AllowPrivateAccess = "true"))
+    float PreviewReuseAngle = 1.0f;
+
+    // Rope Parameters
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rope", meta = (AllowPrivateAccess = "true"))
     float InitialUpwardBoost = 300.0f;
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Forces", meta = (AllowPrivateAccess = "true"))
-    float BasePullStrength = 2000.0f;
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Forces", meta = (AllowPrivateAccess = "true"))
-    float DownwardPullMultiplier = 1.5f;
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Forces", meta = (AllowPrivateAccess = "true"))
-    float HorizontalAntiGravityForce = 800.0f;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rope", meta = (AllowPrivateAccess = "true"))
+    float ReelInSpeed = 1200.0f;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rope", meta = (AllowPrivateAccess = "true"))
+    float ReelOutSpeed = 600.0f;
+    // Reel in from the moment the hook attaches, like a pull; off leaves the rope at its length to swing
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rope", meta = (AllowPrivateAccess = "true"))
+    bool bAutoReelIn = true;
 
     // Distance Thresholds
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Distances", meta = (AllowPrivateAccess = "true"))
     float ReleaseDistance = 100.0f;
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Distances", meta = (AllowPrivateAccess = "true"))
-    float DistanceScaleReference = 100.0f;
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Distances", meta = (AllowPrivateAccess = "true"))
-    float HorizontalGrappleThreshold = 100.0f;
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Distances", meta = (AllowPrivateAccess = "true"))
-    float MinHorizontalDistanceForAntiGravity = 200.0f;
 
     // Boost Conditions
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boost", meta = (AllowPrivateAccess = "true"))
     float MinVerticalBoostHeight = 50.0f;
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boost", meta = (AllowPrivateAccess = "true"))
     float MinHorizontalBoostDistance = 300.0f;
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Visuals", meta = (AllowPrivateAccess = "true"))
-    float CableInterpSpeed = 30.0f;
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grapple Mantling", meta = (AllowPrivateAccess = "true"))
     float MantleDuration = 0.5f;
 
+    UPROPERTY()
+    UGrapplePointSubsystem* GrapplePoints;
     float CurrentCooldown;
     bool bIsGrappling;
     bool bIsMantling;
+    // Simulated proxy showing a grapple from a multicast event: cable and audio only, no forces
+    bool bIsProxyGrapple = false;
     FVector GrappleLocation;
-    float Distance;
     float OriginalCapsuleHalfHeight;
     FVector MantleStartLocation;
     FVector MantleTargetLocation;
     float MantleAlpha;
+    // Computed in ComputeTick, applied in ApplyTick
+    bool bPendingClimb = false;
+    bool bPendingRelease = false;
+    
+    // Pull path planned at attach time; the tick only checks how close the character is to its end
+    struct FGrapplePath
+    {
+        FVector Start = FVector::ZeroVector;
+        FVector Direction = FVector::ForwardVector;
+        FVector End = FVector::ZeroVector; // capsule center at the first blocking hit, or the anchor when the way is clear
+        float EndRopeLength = 0.0f;        // the rope is reeled in to the end once it is no longer than this
+        FVector MantleTarget = FVector::ZeroVector;
+        bool bCanMantle = false;
+    };
+    FGrapplePath Path;
+    
+    // Latest reachability result and the view it was traced from
+    struct FGrapplePreview
+    {
+        FVector ViewLocation = FVector::ZeroVector;
+        FVector ViewDirection = FVector::ForwardVector;
+        FVector Target = FVector::ZeroVector;
+        uint64 Frame = 0;
+        bool bValid = false;
+        bool bHasResult = false;
+        bool bAimAssist = false; // traced to an indexed candidate rather than along the crosshair
+    };
+    FGrapplePreview Preview;
+    FGrapplePreview PendingPreview;
+    FTraceHandle PreviewTraceHandle;
+    FTraceDelegate PreviewTraceDelegate;
+    uint64 LastPreviewRequestFrame = 0;
+    float PreviewReuseCos = 1.0f;
+    // A crosshair miss is followed straight away by a trace to the aim-assist candidate, like the synchronous fallback
+    bool bPreviewTryAimAssist = false;
+    // Frames a preview may be trusted by TryShoot without any trace of its own
+    static constexpr uint64 MaxPreviewAgeFrames = 30;
     
-    // Force Scaling Constants
-    static constexpr float MinDistanceMultiplier = 0.5f;
-    static constexpr float MaxDistanceMultiplier = 2.0f;
-
     // Private Methods
+    bool FindGrappleTarget(const FVector& ViewLocation, const FVector& ViewDirection, FVector& OutTarget) const;
+    bool FindAimAssistCandidate(const FVector& ViewLocation, const FVector& ViewDirection, FVector& OutCandidate) const;
+    bool IsValidGrappleHit(const FVector& ViewLocation, const FVector& HitLocation) const;
+    bool IsPreviewCurrent(const FVector& ViewLocation, const FVector& ViewDirection) const;
+    void OnPreviewTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum);
     void StartGrapple(const FVector& TargetLocation);
-    void UpdateCableVisuals(float DeltaTime) const;
-    float CalculatePullStrength(const FVector& ToTarget) const;
-    bool ShouldApplyAntiGravity(const FVector& ToTarget) const;
-    void UpdateMantle(const float DeltaTime);
-    bool ValidateLandingSpace(const FVector& ObstacleTop) const;
+    // One capsule sweep at attach time: where the pull ends and whether it ends in a mantle
+    void PlanPath();
+    void StartGrappleEffects();
+    void StopGrappleEffects();
+    
+    UFUNCTION(NetMulticast, Reliable)
+    void MulticastGrappleStarted(FVector_NetQuantize TargetLocation);
+    UFUNCTION(NetMulticast, Reliable)
+    void MulticastGrappleReleased();
+    void UpdateCableVisuals() const;
+    void UpdateMantle();
+    bool ValidateLandingSpace(const FVector& ObstacleTop, const FVector& Direction) const;
 };
\ No newline at end of file
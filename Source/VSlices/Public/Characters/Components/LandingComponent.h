@@ -20,11 +20,15 @@ class VSLICES_API ULandingComponent : public UParkourComponentBase
 public:	
     ULandingComponent();
 
-    // Called from character's Tick
-    void HandleFallDetection();
     void HandleLanding(float FallDistance) const;
 
+protected:
+    virtual void BeginPlay() override;
+
 private:
+    // Fall start and landing come from the owner's movement mode transitions; nothing runs while grounded
+    void OnMovementModeChanged(EMovementMode PrevMode, uint8 PrevCustomMode, EMovementMode NewMode, uint8 NewCustomMode);
+    
     float FallStartZ = 0.f;
     bool bWasFalling = false;
     float LastVelocity = 0.f;
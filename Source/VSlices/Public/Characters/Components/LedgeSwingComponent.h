@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Characters/Components/ParkourComponentBase.h"
+#include "Engine/NetSerialization.h"
 #include "LedgeSwingComponent.generated.h"
 
 UENUM(BlueprintType)
@@ -12,6 +13,25 @@ enum class EHangType : uint8
 	Pole        // Cylindrical - can swing
 };
 
+// Hang start sent to simulated proxies: 2-bit type, quantized grab point and wall normal
+USTRUCT()
+struct FHangNetEvent
+{
+	GENERATED_BODY()
+	
+	EHangType HangType = EHangType::None;
+	FVector_NetQuantize Location;
+	FVector_NetQuantizeNormal Normal;
+	
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FHangNetEvent> : public TStructOpsTypeTraitsBase2<FHangNetEvent>
+{
+	enum { WithNetSerializer = true };
+};
+
 UCLASS()
 class VSLICES_API ULedgeSwingComponent : public UParkourComponentBase
 {
@@ -27,16 +47,33 @@ public:
     EHangType GetCurrentHangType() const { return CurrentHangType; }
 
 protected:
-    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+    virtual void BeginPlay() override;
+    virtual void ComputeTick(float DeltaTime, const FParkourRunnerState& State) override;
+    virtual void ApplyTick(float DeltaTime) override;
+    virtual EParkourSimChannel GetSimulationChannel() const override { return EParkourSimChannel::LedgeSwing; }
+    virtual bool IsSimulationActive() const override { return (bIsHanging && !bIsProxyHang) || bScanning; }
 
 private:
     bool bIsHanging = false;
+    // Simulated proxy hanging from a multicast event: hang state for the animation only, no movement
+    bool bIsProxyHang = false;
     EHangType CurrentHangType = EHangType::None;
     FVector HangLocation;
     FVector HangNormal;
     float SwingAngle;
     float SwingVelocity;
     float InitialMomentum;
+    float CapsuleRadius = 0.f;
+    FVector PendingHangLocation;
+    // Auto-grab scanner state, only live while falling
+    bool bScanning = false;
+    bool bPendingScan = false;
+    bool bHasScanProbe = false;
+    FVector LastScanProbe;
+    FVector PendingScanProbe;
+    float NextAutoGrabTime = 0.f;
+    UPROPERTY()
+    class UParkourAffordanceSubsystem* Affordances;
     
     // Detection parameters
     UPROPERTY(EditAnywhere, Category = "Detection", meta=(AllowPrivateAccess))
@@ -47,6 +84,26 @@ private:
     float DownwardSearchDistance = 150.0f;
     UPROPERTY(EditAnywhere, Category = "Detection", meta=(AllowPrivateAccess))
     float MinGrabHeight = 50.0f; // Must be this high off ground
+    
+    // Auto grab: while falling, one short sphere sweep per tick from the last probe point to the new one;
+    // full ledge validation only runs when it touches a wall facing the character
+    UPROPERTY(EditAnywhere, Category = "Auto Grab", meta=(AllowPrivateAccess))
+    bool bAutoGrab = true;
+    UPROPERTY(EditAnywhere, Category = "Auto Grab", meta=(AllowPrivateAccess))
+    float ScanHeight = 50.0f; // chest height, same as DetectLedge
+    UPROPERTY(EditAnywhere, Category = "Auto Grab", meta=(AllowPrivateAccess))
+    float ScanReach = 60.0f;
+    UPROPERTY(EditAnywhere, Category = "Auto Grab", meta=(AllowPrivateAccess))
+    float ScanRadius = 10.0f;
+    // The probe has to move this far before it sweeps again; below it the last (empty) result stands
+    UPROPERTY(EditAnywhere, Category = "Auto Grab", meta=(AllowPrivateAccess))
+    float ScanReuseDistance = 5.0f;
+    // Pause after a rejected candidate, so sliding down a plain wall does not validate every frame
+    UPROPERTY(EditAnywhere, Category = "Auto Grab", meta=(AllowPrivateAccess))
+    float FailedGrabRetryDelay = 0.1f;
+    // Pause after letting go, so a drop does not grab the same ledge again
+    UPROPERTY(EditAnywhere, Category = "Auto Grab", meta=(AllowPrivateAccess))
+    float RegrabDelay = 0.5f;
 	
     // Swing parameters (poles)
     UPROPERTY(EditAnywhere, Category = "Swing", meta=(AllowPrivateAccess))
@@ -68,7 +125,15 @@ private:
     void StartHang(const FVector& Location, const FVector& Normal, EHangType HangType);
     void UpdateSwing(float DeltaTime);
     void UpdateHangPosition();
+    FVector CalculateHangPosition() const;
     void ReleaseHang();
+    void OnMovementModeChanged(EMovementMode PrevMode, uint8 PrevCustomMode, EMovementMode NewMode, uint8 NewCustomMode);
+    void ScanForLedge();
+    
+    UFUNCTION(NetMulticast, Reliable)
+    void MulticastHangStarted(const FHangNetEvent& Event);
+    UFUNCTION(NetMulticast, Reliable)
+    void MulticastHangReleased();
     
     bool DetectLedge(FVector& OutLocation, FVector& OutNormal);
     bool DetectPole(FVector& OutLocation, FVector& OutNormal);
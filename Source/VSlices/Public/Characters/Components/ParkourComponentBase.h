@@ -4,6 +4,8 @@
 #include "Components/ActorComponent.h"
 #include "LoggingMacros.h" //for child classes
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Subsystems/ParkourSimulationSubsystem.h"
+#include "ParkourStats.h" //for child classes
 #include "ParkourComponentBase.generated.h"
 
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
@@ -14,10 +16,45 @@ public:
 	
 	UParkourComponentBase();
 	
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	
+	// Per-frame work, run by the component's own tick or by UParkourSimulationSubsystem for crowd runners
+	void SimulateTick(float DeltaTime);
+	// Math on the component's own state only; may run on a worker thread, so no actor, world or subsystem access
+	virtual void ComputeTick(float DeltaTime, const FParkourRunnerState& State) {}
+	// Game thread: write the computed results back to the owner
+	virtual void ApplyTick(float DeltaTime) {}
+	virtual bool IsSimulationActive() const { return false; }
+	
+	FORCEINLINE const FParkourQueryBudget& GetQueryBudget() const { return QueryBudget; }
+	FORCEINLINE int32 GetQueryBudgetPerFrame() const { return QueryBudgetPerFrame; }
+	void ResetQueryBudget();
+	
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	UPROPERTY()
 	class AVSlicesCharacter* OwnerCharacter;
 	UPROPERTY()
 	UCharacterMovementComponent* MovementComponent;
+	
+	virtual EParkourSimChannel GetSimulationChannel() const { return EParkourSimChannel::None; }
+	// Call after any state change that starts or ends per-frame work: the component only ticks while IsSimulationActive
+	void UpdateTickSchedule();
+	// Charges one physics query to this frame's budget; use through PARKOUR_QUERY
+	void RecordQuery() const;
+	// Server of a networked game: parkour events are multicast from here to simulated proxies, one RPC per event
+	bool ShouldBroadcastEvents() const;
+	// Proxies rebuild parkour moves locally from those events instead of from input
+	bool IsSimulatedProxy() const;
+	
+	// Physics queries this component may issue per frame before it counts as over budget, 0 for no limit
+	UPROPERTY(EditAnywhere, Category = "Parkour|Budget")
+	int32 QueryBudgetPerFrame = 0;
+
+private:
+	UPROPERTY()
+	UParkourSimulationSubsystem* Simulation;
+	
+	mutable FParkourQueryBudget QueryBudget;
 };
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "ParkourMovementComponent.generated.h"
+
+class AVSlicesCharacter;
+
+// Parkour state carried by every saved move; packed into NumParkourMoveFlags bits on the wire
+enum class EParkourMoveFlags : uint8
+{
+	None    = 0,
+	Sprint  = 1 << 0,
+	Slide   = 1 << 1,
+	WallRun = 1 << 2,
+	Vault   = 1 << 3,
+	Grapple = 1 << 4
+};
+ENUM_CLASS_FLAGS(EParkourMoveFlags);
+
+// CustomMovementMode values used with MOVE_Custom
+enum class EParkourCustomMode : uint8
+{
+	Grapple = 0
+};
+
+// Inextensible rope from the character to a fixed anchor, simulated by PhysRope
+struct FParkourRope
+{
+	FVector Anchor = FVector::ZeroVector;
+	float Length = 0.f;
+	float ReelRate = 0.f; // cm/s, positive shortens the rope
+	float StepRemainder = 0.f; // simulated time not yet consumed by a whole rope step
+	bool bActive = false;
+};
+
+// Where the character stands after this frame's movement; read by slope, slide and wall-run instead of each querying the floor
+struct FParkourGroundState
+{
+	static constexpr float NoFloorDistance = TNumericLimits<float>::Max();
+	
+	FHitResult FloorHit;                          // valid only while walking on a floor
+	FVector FloorNormal = FVector::UpVector;
+	FVector SlopeDirection = FVector::ZeroVector; // unit vector pointing downhill, zero on flat ground
+	float FloorDotUp = 1.f;                       // cosine of the slope angle; compare against precomputed cosines
+	float FloorDistance = NoFloorDistance;        // capsule bottom to floor; NoFloorDistance when nothing is within probe range
+	bool bWalkableFloor = false;
+	bool bIsFalling = false;
+	bool bHasFloorDistance = false;               // airborne distance is only probed when someone asks, see ProbeFloorDistance
+	uint64 Frame = 0;
+	
+	// Degrees; costs an acos, so only for display and Blueprint
+	FORCEINLINE float GetSlopeAngle() const { return FMath::RadiansToDegrees(FMath::Acos(FloorDotUp)); }
+};
+
+/**
+ * Character movement with client prediction for the parkour moves.
+ * The owning client gathers sprint/slide/wall-run/vault/grapple state from the parkour components each frame and
+ * sends it with its moves; the server starts and stops the same moves on its components at the same timestamp,
+ * and max speed is derived from the move's flags so replayed moves match what the client simulated.
+ */
+UCLASS()
+class VSLICES_API UParkourMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+	class FSavedMove_Parkour : public FSavedMove_Character
+	{
+		typedef FSavedMove_Character Super;
+	public:
+		EParkourMoveFlags ParkourFlags = EParkourMoveFlags::None;
+		// Rope state at the start of the move, so replays reel and step from where the original move did
+		float RopeLength = 0.f;
+		float RopeReelRate = 0.f;
+		float RopeStepRemainder = 0.f;
+
+		virtual void Clear() override;
+		virtual void SetMoveFor(ACharacter* Character, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+		virtual void PrepMoveFor(ACharacter* Character) override;
+		virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+		virtual bool IsImportantMove(const FSavedMovePtr& LastAckedMove) const override;
+	};
+
+	class FNetworkPredictionData_Client_Parkour : public FNetworkPredictionData_Client_Character
+	{
+		typedef FNetworkPredictionData_Client_Character Super;
+	public:
+		explicit FNetworkPredictionData_Client_Parkour(const UCharacterMovementComponent& ClientMovement) : Super(ClientMovement) {}
+		virtual FSavedMovePtr AllocateNewMove() override;
+	};
+
+	struct FParkourNetworkMoveData : public FCharacterNetworkMoveData
+	{
+		EParkourMoveFlags ParkourFlags = EParkourMoveFlags::None;
+		// Whole cm/s, see SetRopeReelRate; only on the wire while grappling
+		int16 RopeReelRate = 0;
+
+		virtual void ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType) override;
+		virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
+	};
+
+	struct FParkourNetworkMoveDataContainer : public FCharacterNetworkMoveDataContainer
+	{
+		FParkourNetworkMoveDataContainer();
+		FParkourNetworkMoveData ParkourMoveData[3];
+	};
+
+public:
+	static constexpr uint32 NumParkourMoveFlags = 5;
+	
+	UParkourMovementComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual float GetMaxSpeed() const override;
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+	FORCEINLINE EParkourMoveFlags GetParkourFlags() const { return ParkourFlags; }
+	FORCEINLINE bool HasParkourFlag(const EParkourMoveFlags Flag) const { return EnumHasAnyFlags(ParkourFlags, Flag); }
+	FORCEINLINE const FParkourGroundState& GetGroundState() const { return GroundState; }
+	// One floor sweep per frame at most; later calls in the same frame return the stored distance. A snapshot whose
+	// falling state no longer matches the character (left the ground since the last move) is refreshed first
+	float ProbeFloorDistance();
+	
+	// Enters the rope mode: from here on the character swings and reels around Anchor inside the movement substeps
+	void StartRope(const FVector& Anchor, float Length);
+	// Leaves the rope; the caller picks the next movement mode
+	void StopRope();
+	// Rounded to whole cm/s, so the rate sent with the move is exactly the one the client simulated
+	void SetRopeReelRate(float Rate);
+	FORCEINLINE const FParkourRope& GetRope() const { return Rope; }
+	FORCEINLINE bool IsOnRope() const { return MovementMode == MOVE_Custom && CustomMovementMode == static_cast<uint8>(EParkourCustomMode::Grapple); }
+
+protected:
+	virtual void InitializeComponent() override;
+	virtual void MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel) override;
+	virtual void PhysCustom(float DeltaTime, int32 Iterations) override;
+	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
+	virtual bool ServerShouldUseAuthoritativePosition(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientLoc,
+		const FVector& RelativeClientLoc, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
+	virtual bool ServerExceedsAllowablePositionError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientWorldLocation,
+		const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
+
+	// Vault and grapple paths are authored by their components from targets the client already resolved, so the
+	// server takes the client's position for them instead of correcting every frame, as long as its own component
+	// accepted the move too and the client stays within ScriptedMovePositionTolerance of the server's own path
+	UPROPERTY(EditDefaultsOnly, Category = "Parkour|Network")
+	bool bTrustClientDuringScriptedMoves = true;
+	// How far a client may be from the server's vault trajectory or rope position and still be trusted
+	UPROPERTY(EditDefaultsOnly, Category = "Parkour|Network", meta = (EditCondition = "bTrustClientDuringScriptedMoves"))
+	float ScriptedMovePositionTolerance = 100.f;
+	// Wall-run is simulated on both ends; while the server is wall-running too, drift within this distance is not corrected
+	UPROPERTY(EditDefaultsOnly, Category = "Parkour|Network")
+	float WallRunPositionTolerance = 25.f;
+	
+	// Every rope step is exactly this long and leftover time carries into the next update, so swings follow the
+	// same path whatever the frame rate
+	UPROPERTY(EditDefaultsOnly, Category = "Parkour|Rope", meta = (ClampMin = "0.001", ClampMax = "0.05"))
+	float RopeSubstepTime = 1.f / 120.f;
+	// Kept below the grapple's ReleaseDistance, so a fully reeled rope still reaches the release point
+	UPROPERTY(EditDefaultsOnly, Category = "Parkour|Rope")
+	float MinRopeLength = 50.f;
+	// Fraction of the input acceleration that pumps the swing
+	UPROPERTY(EditDefaultsOnly, Category = "Parkour|Rope", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float RopeAirControl = 0.3f;
+
+private:
+	UPROPERTY()
+	AVSlicesCharacter* ParkourCharacter;
+	EParkourMoveFlags ParkourFlags = EParkourMoveFlags::None;
+	FParkourNetworkMoveDataContainer ParkourMoveDataContainer;
+	FParkourGroundState GroundState;
+	FParkourRope Rope;
+	// Caps the steps one long update can run; the rest of its time is dropped
+	static constexpr int32 MaxRopeSteps = 16;
+	// Where the last rope step started; the mesh is drawn between it and the step's end by the leftover time
+	FVector RopeStepStartLocation = FVector::ZeroVector;
+	bool bHasRopeStepStart = false;
+	bool bRopeMeshOffset = false;
+
+	EParkourMoveFlags GatherParkourFlags() const;
+	// Server: bring the components in line with the flags of the move being replayed
+	void ApplyParkourFlags(EParkourMoveFlags NewFlags);
+	bool IsScriptedMove() const;
+	// Scripted move the client is trusted with at this position: close enough to where the server put the character
+	bool IsTrustedScriptedMove(const FVector& ClientWorldLocation) const;
+	void UpdateGroundState();
+	void PhysRope(float DeltaTime, int32 Iterations);
+	// Locally controlled only: smooths the mesh (and the camera on it) over updates that run no whole rope step
+	void UpdateRopeMeshOffset();
+};
@@ -28,6 +28,7 @@ public:
 	
 	UFUNCTION(BlueprintCallable, Category = "Slide")
 	bool IsSliding() const { return bIsSliding; }
+	FORCEINLINE float GetSlideSpeed() const { return SlideSpeed; }
 	
 	UFUNCTION(BlueprintCallable, Category = "Slide")
 	void HandleSlideTick(float DeltaSeconds);
@@ -55,8 +56,4 @@ private:
 	bool bIsSliding = false;
 	float SlideElapsed = 0.0f;
 	float ActualSlideDuration = 0.0f;
-	FTimerHandle SlideTimerHandle;
-	
-	// Cached speed for restoration
-	float CachedCrouchSpeed = 0.0f;
 };
\ No newline at end of file
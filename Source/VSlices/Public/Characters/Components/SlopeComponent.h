@@ -23,11 +23,24 @@ struct FSlopeInfo
 	UPROPERTY(BlueprintReadOnly)
 	bool bIsDownhill = false;
 	UPROPERTY(BlueprintReadOnly)
-	float SlopeAngle = 0.0f;
+	float SlopeAngle = 0.0f; // degrees; only filled by GetSlopeInfo, C++ compares FloorDotUp instead
+	UPROPERTY(BlueprintReadOnly)
+	float FloorDotUp = 1.0f; // cosine of the slope angle
 	UPROPERTY(BlueprintReadOnly)
 	float FacingAlignment = 0.0f; // -1 = uphill, +1 = downhill, 0 = sideways
 };
 
+// Slope angle thresholds as cosines: an angle is steeper than a threshold when its cosine is smaller
+struct FSlopeThresholds
+{
+	float MinSlopeCos = 1.f;
+	float SpeedDecreaseCos = 1.f;
+	float MaxUphillCos = 1.f;
+	float MaxDownhillCos = 1.f;
+	float UphillThreshold = 0.f;
+	float DownhillThreshold = 0.f;
+};
+
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class VSLICES_API USlopeComponent : public UParkourComponentBase
 {
@@ -37,11 +50,22 @@ public:
 	USlopeComponent();
 
 	UFUNCTION(BlueprintCallable, Category = "Slope")
-	FSlopeInfo GetSlopeInfo();
+	FSlopeInfo GetSlopeInfo() const;
 	UFUNCTION(BlueprintCallable, Category = "Slope")
 	void ApplySlopeRestrictions(FVector2D& MovementVector);
+	// Call after changing the slope angles at runtime; they are turned into cosines once at BeginPlay
+	UFUNCTION(BlueprintCallable, Category = "Slope")
+	void RefreshSlopeThresholds();
+	
+	// Same as GetSlopeInfo without the degree angle
+	FSlopeInfo ClassifySlope() const;
+	FORCEINLINE const FSlopeThresholds& GetSlopeThresholds() const { return Thresholds; }
+	
+	static FSlopeInfo ClassifyNormal(const FSlopeThresholds& Thresholds, const FVector& FloorNormal, const FVector& Forward);
 
 protected:
+	virtual void BeginPlay() override;
+	
 	// Slope settings
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Slope", meta = (ClampMin = "25.0", ClampMax = "50.0"))
 	float MinSlopeSpeedDecreaseAngle = 25.0f;
@@ -57,12 +81,7 @@ protected:
 	float DownhillThreshold = 0.1f;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Slope")
 	float MinSlopeAngle = 5.0f;
-	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Slope", meta = (ClampMin = "0.01", ClampMax = "0.1"))
-	float SlopeUpdateInterval = 0.1f;
 
 private:
-	FSlopeInfo CachedSlopeInfo;
-	float LastSlopeUpdateTime = 0.0f;
-	
-	void UpdateSlopeInfo();
+	FSlopeThresholds Thresholds;
 };
\ No newline at end of file
@@ -29,9 +29,13 @@ public:
 	bool CanSprint() const { return bCanSprint && !bSprintOnCooldown; }
 	UFUNCTION(BlueprintCallable, Category = "Sprint")
 	bool GetIsSprinting() const { return bIsSprinting; }
+	// Server side of a client-predicted sprint: takes the move's state without the input checks
+	void SetSprinting(const bool bNewSprinting) { bIsSprinting = bNewSprinting; }
 	
 	// Called by character's move function
 	void SprintCheck(float ForwardValue, float RightValue);
+	// Called by the character when EParkourCooldown::Sprint expires
+	void EndSprintCooldown();
 
 protected:
 	virtual void BeginPlay() override;
@@ -44,10 +48,6 @@ private:
 	bool bCanSprint = false;
 	UPROPERTY(BlueprintReadOnly, Category = "Sprint", meta = (AllowPrivateAccess = "true"))
 	bool bSprintOnCooldown = false;
-	
-	FTimerHandle SprintCooldownTimerHandle;
 
 	void StartSprintCooldown();
-	UFUNCTION()
-	void EndSprintCooldown();
 };
\ No newline at end of file
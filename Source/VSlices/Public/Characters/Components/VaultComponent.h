@@ -3,8 +3,14 @@
 #include "CoreMinimal.h"
 #include "ParkourComponentBase.h"
 #include "Components/ActorComponent.h"
+#include "WorldCollision.h"
+#include "Engine/NetSerialization.h"
+#include "Subsystems/ParkourAffordanceSubsystem.h"
 #include "VaultComponent.generated.h"
 
+class UVaultRootMotionCurves;
+struct FVaultRootMotionCurve;
+
 UENUM(BlueprintType)
 enum class EVaultType : uint8
 {
@@ -26,6 +32,23 @@ struct FVaultableObstacle
 	bool bIsThick;       // true = climb, false = vault
 };
 
+// Vault start sent to simulated proxies: 2-bit type for the montage, position comes from replicated movement
+USTRUCT()
+struct FVaultNetEvent
+{
+	GENERATED_BODY()
+	
+	EVaultType VaultType = EVaultType::Vault_Short;
+	
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FVaultNetEvent> : public TStructOpsTypeTraitsBase2<FVaultNetEvent>
+{
+	enum { WithNetSerializer = true };
+};
+
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class VSLICES_API UVaultComponent : public UParkourComponentBase
 {
@@ -39,7 +62,11 @@ public:
 	UVaultComponent();
 
 	bool TryVault(const bool bWasSprinting);
-	bool IsVaulting() const { return bIsVaulting; }
+	// False while the runner is still where the last search found nothing, within the prediction tolerances
+	bool HasMovedSinceFailedVault(const bool bWasSprinting) const;
+	bool IsVaulting() const { return bIsVaulting || bIsProxyVault; }
+	// Where the trajectory puts the character at the current vault time; false when no vault is being simulated
+	bool GetTrajectoryLocation(FVector& OutLocation) const;
 
 	UPROPERTY(EditDefaultsOnly, Category="Vaulting|Animations")
 	UAnimMontage* VaultShortMontage;
@@ -49,13 +76,19 @@ public:
 	UAnimMontage* ClimbShortMontage;
 	UPROPERTY(EditDefaultsOnly, Category="Vaulting|Animations")
 	UAnimMontage* ClimbTallMontage;
+	// Baked by -run=VaultCurveBake; vault types without a curve fall back to the solver
+	UPROPERTY(EditDefaultsOnly, Category="Vaulting|Animations")
+	TSoftObjectPtr<UVaultRootMotionCurves> RootMotionCurves;
 	EVaultType CurrentVaultType;
 
 	void FinishVault();
 
 protected:
 	virtual void BeginPlay() override;
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void ComputeTick(float DeltaTime, const FParkourRunnerState& State) override;
+	virtual void ApplyTick(float DeltaTime) override;
+	virtual EParkourSimChannel GetSimulationChannel() const override { return EParkourSimChannel::Vault; }
+	virtual bool IsSimulationActive() const override { return bIsVaulting || bUseAsyncTraces; }
 	
 	UPROPERTY(EditAnywhere, Category="Vault|Tracing")
 	float MinTraceHeight = -40.0f;
@@ -72,40 +105,156 @@ protected:
 	float MaxHeightForTraverse = 216.f;
 	UPROPERTY(EditAnywhere, Category="Vault")
 	float ThicknessForClimb = 60.f;
+	//async prediction
+	UPROPERTY(EditAnywhere, Category="Vault|Async")
+	bool bUseAsyncTraces = false;
+	UPROPERTY(EditAnywhere, Category="Vault|Async", meta=(EditCondition="bUseAsyncTraces"))
+	float PredictionLocationTolerance = 50.f;
+	UPROPERTY(EditAnywhere, Category="Vault|Async", meta=(EditCondition="bUseAsyncTraces"))
+	float PredictionMinForwardDot = 0.98f;
+	// A finished prediction that still matches the runner is reused for this long before probing again
+	UPROPERTY(EditAnywhere, Category="Vault|Async", meta=(EditCondition="bUseAsyncTraces"))
+	float PredictionMaxAge = 0.2f;
+	// Below this speed the probes only go out again while the last prediction saw an obstacle
+	UPROPERTY(EditAnywhere, Category="Vault|Async", meta=(EditCondition="bUseAsyncTraces"))
+	float PredictionMinSpeed = 10.f;
+	UPROPERTY(EditAnywhere, Category="Vault|Cache")
+	bool bUseObstacleCache = true;
 	
 private:
+	enum class EVaultPredictionStage : uint8
+	{
+		Idle,
+		Probing,     // multi-height probe fan in flight
+		WallTop,     // wall top trace in flight
+		Validating,  // thickness trace + landing overlap in flight
+		Ready
+	};
+	struct FVaultPrediction
+	{
+		EVaultPredictionStage Stage = EVaultPredictionStage::Idle;
+		FVector Origin = FVector::ZeroVector;
+		FVector Forward = FVector::ForwardVector;
+		bool bWasSprinting = false;
+		int32 PendingQueries = 0;
+		FHitResult BestHit;
+		float ClosestDistance = MAX_FLT;
+		FVector ObstacleTop = FVector::ZeroVector;
+		float ObstacleHeight = 0.f;
+		bool bHasSpace = false;
+		bool bIsThick = false;
+		bool bCachedAnalysis = false;  // thickness already known, only the landing overlap is traced
+		bool bBakedTop = false;        // ObstacleTop came from the index, the wall top trace only looks for movable objects on it
+		bool bDynamicTop = false;      // a movable object sits on the baked top; not cached
+		bool bFound = false;
+		float CompletedTime = 0.f;
+	};
+
 	FVector VaultStartLocation;
 	FVector VaultTargetLocation;
 	FRotator VaultStartRotation;
 	FRotator VaultTargetRotation;
-	float VaultLerpAlpha = 0.f;
+	float VaultElapsed = 0.f;
 	float VaultLerpTime = 0.8f;
 	float VaultArcPeak;
-	FTimerHandle VaultMoveTimerHandle;
 
 	//EVaultType VaultType;
 	bool bIsVaulting = false;
+	// Simulated proxy playing a vault montage from a multicast event: animation only, no movement
+	bool bIsProxyVault = false;
 	bool PerformTrace(FHitResult& OutHit, const FVector& Start, const FVector& End) const;
 
 	//cache
 	FCollisionQueryParams TraceParams;
+	FCollisionQueryParams DynamicTraceParams;
 	FCollisionObjectQueryParams ObjectParams;
 	float CapsuleRadius = 0.f;
 	float CapsuleHalfHeight = 0.f;
+	UPROPERTY()
+	class UVaultObstacleCacheSubsystem* ObstacleCache;
+	UPROPERTY()
+	UParkourAffordanceSubsystem* Affordances;
+	UPROPERTY()
+	UVaultRootMotionCurves* LoadedCurves;
+	TEnumAsByte<ERootMotionMode::Type> PreviousRootMotionMode = ERootMotionMode::RootMotionFromMontagesOnly;
     
 	bool FindVaultableObstacle(FVaultableObstacle& OutObstacle, bool bWasSprinting) const;
+	void GetProbeSegment(int32 Index, const FVector& Origin, const FVector& Forward, bool bWasSprinting, FVector& OutStart, FVector& OutEnd) const;
+	void GetWallTopSegment(const FHitResult& WallHit, FVector& OutStart, FVector& OutEnd) const;
+	void GetThicknessSegment(const FHitResult& Hit, const FVector& WallTop, FVector& OutStart, FVector& OutEnd) const;
+	FVector GetLandingPosition(const FVector& ObstacleTop, const FVector& Forward) const;
+	FCollisionShape GetLandingShape() const;
+	FVector GetObstacleTop(const FHitResult& Hit, const float TopZ) const;
+	// Only static walls are answered from the baked index; movable obstacles always report Unknown and get traced
+	EParkourAffordanceQuery QueryWallTop(const FHitResult& WallHit, const FVector& Start, const FVector& End, float& OutTopZ) const;
+	const FCollisionQueryParams& GetQueryParams(const EParkourAffordanceQuery Query) const;
 	bool AnalyzeObstacle(const FHitResult& Hit, FVaultableObstacle& OutObstacle) const;
-	bool FindWallTop(const FHitResult& WallHit, FVector& OutWallTop, float& OutHeight) const;
+	// bOutDynamicTop: the top is a movable object resting on the baked wall, so the result must not be cached
+	bool FindWallTop(const FHitResult& WallHit, FVector& OutWallTop, float& OutHeight, bool& bOutDynamicTop) const;
 	bool ValidateLandingSpace(const FVector& ObstacleTop) const;
 	bool ExecuteVault(const FVaultableObstacle& Obstacle);
 	void StartVault(const EVaultType VaultType, const FVector& TargetLocation, const FRotator& TargetRotation);
 	
-	void UpdateVaultMotion(const float DeltaTime) const;
-	void UpdateClimbMotion(const float DeltaTime) const;
-	float CalculateArcOffset() const;
+	// Writes computed in ComputeTick, applied to the owner in ApplyTick
+	struct FVaultMotionStep
+	{
+		FVector Location = FVector::ZeroVector;
+		FVector Velocity = FVector::ZeroVector;
+		FRotator Rotation = FRotator::ZeroRotator;
+	};
+	FVaultMotionStep PendingMotion;
+	
+	// Fixed-step solver: StartVault integrates the whole path once at TrajectorySubstep, ticks only sample it by elapsed
+	// time, so the path is the same at any tick rate
+	static constexpr float TrajectorySubstep = 1.f / 120.f;
+	static constexpr int32 MaxTrajectorySteps = 600;
+	TArray<FVector> TrajectoryPoints;
+	TArray<FRotator> TrajectoryRotations;
+	float TrajectoryStep = TrajectorySubstep;
+	bool bTrajectoryFromCurve = false;
+	
+	void BuildTrajectory();
+	void WarpCurveStep(const FVaultRootMotionCurve& Curve, float Alpha, FVector& OutLocation) const;
+	void IntegrateVaultStep(float Alpha, float Step, FVector& InOutLocation) const;
+	void IntegrateClimbStep(float Alpha, FVector& InOutLocation) const;
+	void SampleTrajectory(float Time, FVaultMotionStep& OutMotion) const;
+	float CalculateArcOffset(float Alpha) const;
 	
 	bool IsObstacleThick(const FHitResult& Hit, const FVector& WallTop) const;
 	
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastVaultStarted(const FVaultNetEvent& Event);
+	void OnProxyMontageEnded(UAnimMontage* Montage, bool bInterrupted);
+	
+	// Async pipeline: probe fan -> wall top -> thickness/landing, one stage per frame. The pipeline fills Prediction,
+	// TryVault reads LastPrediction, the latest finished one, so a result is never lost to the next restart
+	FVaultPrediction Prediction;
+	FVaultPrediction LastPrediction;
+	// Where the last TryVault found nothing; only Origin, Forward and bWasSprinting are used
+	FVaultPrediction FailedAttempt;
+	bool bHasFailedAttempt = false;
+	static constexpr int32 NumProbeTraces = 5;
+	FTraceHandle ProbeHandles[NumProbeTraces];
+	FTraceHandle WallTopHandle;
+	FTraceHandle ThicknessHandle;
+	FTraceHandle LandingHandle;
+	FTraceDelegate ProbeTraceDelegate;
+	FTraceDelegate WallTopTraceDelegate;
+	FTraceDelegate ThicknessTraceDelegate;
+	FOverlapDelegate LandingOverlapDelegate;
+	
+	void StartPrediction();
+	bool IsPredictionCurrent(const FVaultPrediction& Result, const bool bWasSprinting) const;
+	void IssuePredictionValidation();
+	void FinishValidation();
+	void FinishPrediction(const bool bFound);
+	void StorePrediction(const bool bHasTop) const;
+	bool ConsumePrediction(const bool bWasSprinting, bool& bOutFound, FVaultableObstacle& OutObstacle);
+	void OnProbeTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+	void OnWallTopTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+	void OnThicknessTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+	void OnLandingOverlapDone(const FTraceHandle& Handle, FOverlapDatum& Datum);
+	
 	UAnimMontage* GetVaultMontage(const EVaultType VaultType) const;
 	void DrawTraceDebug(const FVector& Start, const FVector& End, const bool bHit, const FVector& HitLocation) const;
 };
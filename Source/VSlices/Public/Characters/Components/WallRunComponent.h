@@ -21,9 +21,13 @@ public:
 	
 protected:
 	virtual void BeginPlay() override;
+	virtual EParkourSimChannel GetSimulationChannel() const override { return EParkourSimChannel::WallRun; }
+	virtual bool IsSimulationActive() const override { return bIsWallRunning || bCameraTilt; }
+	void OnOwnerLanded(const FHitResult& Hit);
 
 public:	
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void ComputeTick(float DeltaTime, const FParkourRunnerState& State) override;
+	virtual void ApplyTick(float DeltaTime) override;
 
 	void TryWallRun(const FHitResult& Hit);
 	void StartWallRun(const FVector& WallNormal);
@@ -39,8 +43,14 @@ public:
 private:
 	bool bIsWallRunning;
 	bool bCameraTilt;
+	bool bPendingStop = false;
 	float LastWallRunAttempt = 0.0f;
 	float WallRunAttemptCooldown = 0.1f;
+	// Rejects floor scrapes, ceilings and slow or head-on hits from the hit alone, before any query
+	bool PassesPrefilter(const FHitResult& Hit) const;
+	// Whether an actor can be wall-run at all: not a pawn, not simulating physics, no NoWallRun tag. Checked on every
+	// hit that passes the prefilter, so tag and physics changes apply straight away
+	bool IsRunnableSurface(const AActor* WallActor) const;
 	bool CheckForWall(const FHitResult& Hit);
 	float DefaultGravityScale;
 	void UpdateCameraTilt(float DeltaTime);
@@ -62,11 +72,16 @@ private:
 	float MinWallAngleDot = 0.6f;
 	UPROPERTY(EditDefaultsOnly, Category="Wall Run", meta=(AllowPrivateAccess))
 	float MinVelocity = 300.f;
+	// Hits whose normal points further up or down than this are floors or ceilings, not walls
+	UPROPERTY(EditDefaultsOnly, Category="Wall Run", meta=(AllowPrivateAccess, ClampMin = "0.0", ClampMax = "1.0"))
+	float MaxWallNormalZ = 0.3f;
+	// Actors carrying this tag are never wall-run
+	UPROPERTY(EditDefaultsOnly, Category="Wall Run", meta=(AllowPrivateAccess))
+	FName NoWallRunTag = TEXT("NoWallRun");
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Tilt", meta = (ClampMin = "0.0", ClampMax = "45.0"), meta=(AllowPrivateAccess))
 	float CameraTiltAngle = 15.0f;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Tilt", meta = (ClampMin = "0.1", ClampMax = "20.0"), meta=(AllowPrivateAccess))
 	float CameraTiltSpeed = 5.0f;
 	
-	FTimerHandle WallRunTimerHandle;
 	EWallRunDir Direction = EWallRunDir::None;
 };
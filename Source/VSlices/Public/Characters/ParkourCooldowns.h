@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// One slot per timed parkour rule, see FParkourCooldowns
+enum class EParkourCooldown : uint8
+{
+	Jump,           // jump unavailable until it expires
+	Sprint,         // sprint unavailable until it expires
+	WallRun,        // wall-run ends when it expires
+	LaunchForward,  // sprint-jump boost fires when it expires
+	Num
+};
+
+/**
+ * Fixed table of world-time deadlines, one per EParkourCooldown, stored inline in the character.
+ * Replaces FTimerManager for the short parkour timers: starting one is a single store, and the character's Tick
+ * expires them all with one pass over the table, so no timer entries or delegates are created per jump.
+ */
+struct FParkourCooldowns
+{
+	static constexpr int32 Num = static_cast<int32>(EParkourCooldown::Num);
+	static_assert(Num <= 8, "Expired slots are returned as a byte mask");
+	
+	FORCEINLINE void Start(const EParkourCooldown Cooldown, const double Now, const float Duration)
+	{
+		Deadlines[static_cast<int32>(Cooldown)] = Now + Duration;
+		ActiveMask |= 1 << static_cast<int32>(Cooldown);
+	}
+	
+	FORCEINLINE void Clear(const EParkourCooldown Cooldown)
+	{
+		ActiveMask &= ~(1 << static_cast<int32>(Cooldown));
+	}
+	
+	FORCEINLINE bool IsActive(const EParkourCooldown Cooldown) const
+	{
+		return (ActiveMask & (1 << static_cast<int32>(Cooldown))) != 0;
+	}
+	
+	FORCEINLINE float GetRemaining(const EParkourCooldown Cooldown, const double Now) const
+	{
+		return IsActive(Cooldown) ? static_cast<float>(FMath::Max(Deadlines[static_cast<int32>(Cooldown)] - Now, 0.0)) : 0.f;
+	}
+	
+	// Clears every slot whose deadline has passed and returns them as a bit mask
+	uint8 Expire(const double Now)
+	{
+		uint8 Expired = 0;
+		for (uint8 Mask = ActiveMask; Mask; Mask &= Mask - 1)
+		{
+			const int32 Index = FMath::CountTrailingZeros(static_cast<uint32>(Mask));
+			if (Deadlines[Index] <= Now)
+				Expired |= 1 << Index;
+		}
+		ActiveMask &= ~Expired;
+		return Expired;
+	}
+
+private:
+	double Deadlines[Num] = {};
+	uint8 ActiveMask = 0;
+};
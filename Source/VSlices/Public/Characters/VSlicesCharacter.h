@@ -4,11 +4,20 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "Characters/ParkourCooldowns.h"
 #include "VSlicesCharacter.generated.h"
 
 struct FInputActionValue;
 
-DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
+DECLARE_MULTICAST_DELEGATE_FourParams(FParkourMovementModeChanged, EMovementMode /*PrevMode*/, uint8 /*PrevCustomMode*/, EMovementMode /*NewMode*/, uint8 /*NewCustomMode*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FParkourLanded, const FHitResult& /*Hit*/);
+
+// Movement transitions broadcast by the character, so components can react to them instead of polling every tick
+struct FParkourMovementEvents
+{
+	FParkourMovementModeChanged OnMovementModeChanged;
+	FParkourLanded OnLanded;
+};
 
 UCLASS(config=Game)
 class AVSlicesCharacter : public ACharacter
@@ -55,8 +64,11 @@ class AVSlicesCharacter : public ACharacter
 	
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
 	float CoyoteTimeDuration = 0.15f;
+	// Crowd runners: parkour components are ticked in one pass by UParkourSimulationSubsystem
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	bool bUseParkourSimulation = false;
 public:
-	AVSlicesCharacter();
+	AVSlicesCharacter(const FObjectInitializer& ObjectInitializer);
 	
 	void Move(const FInputActionValue& Value);
 	void Look(const FInputActionValue& Value);
@@ -69,14 +81,19 @@ public:
 	void StopSprinting() const;
 	// Crouch and jump
 	void ToggleCrouch();
+	// False while crouching is not possible (vaulting, hanging, grappling), so the controller can buffer the press
+	bool TryToggleCrouch();
 	void StartCrouch();
 	void StopCrouch();
 	virtual bool CanJumpInternal_Implementation() const override;
 	virtual void Jump() override;
+	// Jump, wall jump, ledge jump or vault; false when none could start this frame. A retry of a buffered press only
+	// searches for a vault again once the runner has moved or turned since the last search came up empty
+	bool TryJump(bool bIsRetry = false);
 	void ResetJumpCooldown();
 	void LaunchForward();
 	//Grappling Hook
-	void ShootGrapplingHook() const;
+	bool ShootGrapplingHook() const;
 
 protected:
 	virtual void Tick(float DeltaSeconds) override;
@@ -95,15 +112,24 @@ public:
 	UVaultComponent* GetVaultComponent() const;
 	ULandingComponent* GetLandingComponent() const;
 	UWallRunComponent* GetWallRunComponent() const;
+	UGrapplingHookComponent* GetGrapplingHookComponent() const;
+	class UParkourMovementComponent* GetParkourMovement() const;
 
+	// Classification only; SlopeAngle is left at 0, Blueprint gets it from USlopeComponent::GetSlopeInfo
 	struct FSlopeInfo GetSlopeInfo() const;
+	const struct FParkourGroundState& GetGroundState() const;
 
 	FORCEINLINE float GetMaxJogSpeed() const { return MaxJogSpeed; }
 	FORCEINLINE float GetMaxCrouchJogSpeed() const { return MaxCrouchJogSpeed; }
 	FORCEINLINE float GetMaxSprintSpeed() const { return MaxSprintSpeed; }
 	FORCEINLINE float GetMaxCrouchSprintSpeed() const { return MaxCrouchSprintSpeed; }
+	FORCEINLINE bool UsesParkourSimulation() const { return bUseParkourSimulation; }
+	// Only takes effect before BeginPlay, when components decide how they tick
+	FORCEINLINE void SetUseParkourSimulation(const bool bUse) { bUseParkourSimulation = bUse; }
 	
 	FORCEINLINE UCableComponent* GetCable() const { return Cable; }
+	FORCEINLINE FParkourMovementEvents& GetMovementEvents() { return MovementEvents; }
+	FORCEINLINE FParkourCooldowns& GetCooldowns() { return Cooldowns; }
 	
 	UFUNCTION(BlueprintCallable, Category = Movement)
 	bool GetIsSprinting() const;
@@ -115,6 +141,8 @@ private:
 	bool bInCoyoteTime = true;
     float CoyoteTimeRemaining;
 	
-	FTimerHandle JumpCooldownTimerHandle;
-	//FTimerHandle LedgeDetectionTimerHandle;
+	FParkourCooldowns Cooldowns;
+	FParkourMovementEvents MovementEvents;
+	
+	void OnCooldownsExpired(uint8 ExpiredMask);
 };
\ No newline at end of file
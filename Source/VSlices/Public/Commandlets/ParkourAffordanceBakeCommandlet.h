@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ParkourAffordanceBakeCommandlet.generated.h"
+
+class UParkourAffordanceIndex;
+class UStaticMesh;
+class UStaticMeshComponent;
+
+/**
+ * Scans the static meshes of parkour maps and saves a UParkourAffordanceIndex per map. Editor builds only.
+ * UnrealEditor-Cmd VSlices.uproject -run=ParkourAffordanceBake [-Maps=/Game/Maps/Parkour+/Game/Maps/Other]
+ */
+UCLASS()
+class VSLICES_API UParkourAffordanceBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UParkourAffordanceBakeCommandlet();
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	static constexpr float MaxPoleRadius = 20.f;
+	static constexpr float MinPoleLength = 100.f;
+	
+#if WITH_EDITOR
+	bool BakeMap(const FString& MapPackageName) const;
+	void BakeComponent(const UStaticMeshComponent* Component, UParkourAffordanceIndex* Index) const;
+	void BakeMesh(const UStaticMesh* Mesh, const FTransform& Transform, UParkourAffordanceIndex* Index) const;
+	static void AddOpaqueVolume(const FBox& Bounds, UParkourAffordanceIndex* Index);
+#endif
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "VaultCurveBakeCommandlet.generated.h"
+
+class UAnimMontage;
+struct FVaultRootMotionCurve;
+
+/**
+ * Extracts root motion from the character's vault and climb montages and saves it as UVaultRootMotionCurves.
+ * Run before cooking whenever the montages change. Editor builds only.
+ * UnrealEditor-Cmd VSlices.uproject -run=VaultCurveBake [-Character=/Game/Blueprints/Characters/BP_Character]
+ */
+UCLASS()
+class VSLICES_API UVaultCurveBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UVaultCurveBakeCommandlet();
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	static constexpr float SampleRate = 60.f;
+	static constexpr int32 MaxSamples = 256;
+	
+#if WITH_EDITOR
+	static bool BakeMontage(UAnimMontage* Montage, bool bUpToPeak, FVaultRootMotionCurve& OutCurve);
+#endif
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EParkourInputIntent : uint8
+{
+	Jump,
+	Grapple,
+	Crouch,
+	Num
+};
+
+struct FParkourBufferedInput
+{
+	EParkourInputIntent Intent = EParkourInputIntent::Jump;
+	double Time = 0.0;
+	uint64 Frame = 0;
+	uint8 Attempts = 0; // times the controller has tried to act on it, so retries can take a cheaper path
+	bool bPending = false;
+};
+
+/**
+ * Fixed-capacity ring of timestamped input intents, newest overwriting oldest.
+ * Pushed by the controller's input callbacks and drained in its PlayerTick, both on the game thread, so no locks or
+ * allocations; consumed entries stay in the ring as input history.
+ */
+class FParkourInputBuffer
+{
+public:
+	static constexpr uint32 Capacity = 32;
+	static_assert(FMath::IsPowerOfTwo(Capacity), "Ring index is masked");
+	
+	void Push(const EParkourInputIntent Intent, const double Time, const uint64 Frame)
+	{
+		FParkourBufferedInput& Entry = Entries[Head++ & (Capacity - 1)];
+		Entry.Intent = Intent;
+		Entry.Time = Time;
+		Entry.Frame = Frame;
+		Entry.Attempts = 0;
+		Entry.bPending = true;
+	}
+	
+	// Visits pending entries no older than MinTime, oldest first; the visitor returns true to consume the entry
+	template<typename FunctorType>
+	void ConsumePending(const double MinTime, FunctorType&& Visitor)
+	{
+		const uint32 Count = FMath::Min(Head, Capacity);
+		for (uint32 Index = Head - Count; Index != Head; Index++)
+		{
+			FParkourBufferedInput& Entry = Entries[Index & (Capacity - 1)];
+			if (!Entry.bPending)
+				continue;
+			if (Entry.Time < MinTime || Visitor(Entry))
+				Entry.bPending = false;
+		}
+	}
+	
+	void Reset()
+	{
+		Head = 0;
+		for (FParkourBufferedInput& Entry : Entries)
+			Entry.bPending = false;
+	}
+	
+	// Most recent entries first, Index 0 is the newest
+	const FParkourBufferedInput* GetHistory(const uint32 Index) const
+	{
+		return Index < FMath::Min(Head, Capacity) ? &Entries[(Head - 1 - Index) & (Capacity - 1)] : nullptr;
+	}
+
+private:
+	FParkourBufferedInput Entries[Capacity];
+	uint32 Head = 0;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Controller input events captured by FParkourInputRecorder, in file order
+enum class EParkourInputAction : uint8
+{
+	Move,
+	Look,
+	JumpPressed,
+	JumpReleased,
+	Crouch,
+	Sprint,
+	UnSprint,
+	Grapple,
+	Reel,
+	Num
+};
+
+/**
+ * Input recording file (Saved/InputRecordings/<Name>.pkin):
+ * header {Magic, Version, StepSeconds, Map}, then one record per input event
+ * {packed frame delta, action, int16 x/y for Move, Look and Reel}. Written and read as a stream, nothing is kept in memory.
+ */
+struct FParkourInputRecordingFormat
+{
+	static constexpr uint32 Magic = 0x524B4950; // "PIKR"
+	static constexpr uint16 Version = 1;
+	static constexpr float MoveScale = 32767.f;  // unit axis, full int16 range
+	static constexpr float LookScale = 128.f;    // 1/128 resolution, +-256 per frame
+	
+	static bool HasAxisValue(EParkourInputAction Action) { return Action == EParkourInputAction::Move || Action == EParkourInputAction::Look || Action == EParkourInputAction::Reel; }
+	static int16 Quantize(EParkourInputAction Action, double Value);
+	static double Dequantize(EParkourInputAction Action, int16 Value);
+	static FString GetPath(const FString& Name);
+};
+
+class FParkourInputRecorder
+{
+public:
+	~FParkourInputRecorder();
+	
+	bool Open(const FString& Name, float StepSeconds, const FString& MapName);
+	// Writes the event and returns the value the replay will see, so live play runs on exactly the same input
+	FVector2D Record(uint32 Frame, EParkourInputAction Action, const FVector2D& Value);
+	void Close();
+
+private:
+	TUniquePtr<FArchive> Writer;
+	uint32 LastFrame = 0;
+	uint32 NumEvents = 0;
+};
+
+class FParkourInputPlayer
+{
+public:
+	~FParkourInputPlayer();
+	
+	bool Open(const FString& Name);
+	float GetStepSeconds() const { return StepSeconds; }
+	bool IsFinished() const { return !Reader || bFinished; }
+	
+	// Calls Handler(Action, Value) for every event recorded on Frame, reading ahead by one record
+	template<typename FunctorType>
+	void PlayFrame(const uint32 Frame, FunctorType&& Handler)
+	{
+		while (!IsFinished() && NextFrame <= Frame)
+		{
+			Handler(NextAction, NextValue);
+			ReadNext();
+		}
+	}
+
+private:
+	TUniquePtr<FArchive> Reader;
+	float StepSeconds = 0.f;
+	bool bFinished = false;
+	uint32 NextFrame = 0;
+	EParkourInputAction NextAction = EParkourInputAction::Num;
+	FVector2D NextValue = FVector2D::ZeroVector;
+	
+	void ReadNext();
+};
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
+#include "Controllers/ParkourInputBuffer.h"
+#include "Controllers/ParkourInputRecording.h"
 #include "VSlicesPlayerController.generated.h"
 
 struct FInputActionValue;
@@ -32,11 +34,27 @@ class VSLICES_API AVSlicesPlayerController : public APlayerController
 	UInputAction* SprintAction;
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Input", meta = (AllowPrivateAccess = "true"))
 	UInputAction* GrappleAction;
+	// 1D axis: positive reels the grapple rope in, negative pays it out
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Input", meta = (AllowPrivateAccess = "true"))
+	UInputAction* ReelAction;
+	
+	// How long a press waits for its action to become possible, e.g. a jump pressed just before landing
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Input|Buffer", meta = (AllowPrivateAccess = "true"))
+	float JumpBufferTime = 0.15f;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Input|Buffer", meta = (AllowPrivateAccess = "true"))
+	float GrappleBufferTime = 0.2f;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Input|Buffer", meta = (AllowPrivateAccess = "true"))
+	float CrouchBufferTime = 0.2f;
+	// Fixed step used while recording or replaying input, so both runs simulate the same frames
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Input|Recording", meta = (AllowPrivateAccess = "true"))
+	float RecordingStepSeconds = 1.f / 60.f;
 
 protected:
 	virtual void OnPossess(APawn* InPawn) override;
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void SetupInputComponent() override;
+	virtual void PlayerTick(float DeltaTime) override;
 	
 protected:
 	void Move(const FInputActionValue& Value);
@@ -47,8 +65,28 @@ protected:
 	void Sprint();
 	void UnSprint();
 	void ShootGrapplingHook();
+	void Reel(const FInputActionValue& Value);
+	
+	// Every input event goes through here: live events are recorded (or muted during a replay), then executed
+	void DispatchInput(EParkourInputAction Action, const FVector2D& Value = FVector2D::ZeroVector);
+	void ExecuteInput(EParkourInputAction Action, const FVector2D& Value);
+	void StartInputRecordingOrReplay();
+	void StopInputRecordingOrReplay();
+	
+	void BufferIntent(EParkourInputIntent Intent);
+	void ConsumeBufferedIntents();
+	bool TryIntent(EParkourInputIntent Intent, bool bIsRetry) const;
+	float GetBufferTime(EParkourInputIntent Intent) const;
 	
 private:
 	UPROPERTY()
 	class AVSlicesCharacter* PlayerCharacter;
+	FParkourInputBuffer InputBuffer;
+	
+	// -ParkourRecord=<Name> / -ParkourReplay=<Name>, see FParkourInputRecordingFormat
+	TUniquePtr<FParkourInputRecorder> InputRecorder;
+	TUniquePtr<FParkourInputPlayer> InputPlayer;
+	uint32 InputFrame = 0;
+	bool bWasFixedTimeStep = false;
+	double PreviousFixedDeltaTime = 0.0;
 };
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ParkourAffordanceIndex.generated.h"
+
+// Top of a box-shaped static mesh. Its edges are the ledges, its height is the wall top
+USTRUCT()
+struct FParkourWallTop
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector2f Center = FVector2f::ZeroVector;
+	UPROPERTY()
+	FVector2f Axis = FVector2f(1.f, 0.f); // footprint X axis, unit length
+	UPROPERTY()
+	FVector2f HalfExtents = FVector2f::ZeroVector;
+	UPROPERTY()
+	float BottomZ = 0.f;
+	UPROPERTY()
+	float TopZ = 0.f;
+};
+
+USTRUCT()
+struct FParkourPoleAxis
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector3f Start = FVector3f::ZeroVector;
+	UPROPERTY()
+	FVector3f End = FVector3f::ZeroVector;
+	UPROPERTY()
+	float Radius = 0.f;
+};
+
+// Static geometry the bake could not describe; queries touching it fall back to full traces
+USTRUCT()
+struct FParkourOpaqueVolume
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector3f Min = FVector3f::ZeroVector;
+	UPROPERTY()
+	FVector3f Max = FVector3f::ZeroVector;
+};
+
+/**
+ * Ledge, pole and wall-top affordances baked from a map's static meshes by UParkourAffordanceBakeCommandlet.
+ */
+UCLASS()
+class VSLICES_API UParkourAffordanceIndex : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(VisibleAnywhere, Category = "Affordances")
+	TArray<FParkourWallTop> WallTops;
+	UPROPERTY(VisibleAnywhere, Category = "Affordances")
+	TArray<FParkourPoleAxis> Poles;
+	UPROPERTY(VisibleAnywhere, Category = "Affordances")
+	TArray<FParkourOpaqueVolume> OpaqueVolumes;
+	
+	static FString GetPackageNameForMap(const FString& MapName);
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "VaultRootMotionCurves.generated.h"
+
+class UAnimMontage;
+enum class EVaultType : uint8;
+
+/**
+ * Root motion of one vault montage, normalized and quantized to 16 bits per sample.
+ * Forward is progress along the montage's horizontal travel (0 at start, 1 at the end).
+ * Up is height over the peak for vaults, and over the end height for climbs, so both can be warped to any obstacle.
+ */
+USTRUCT()
+struct FVaultRootMotionCurve
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSoftObjectPtr<UAnimMontage> Montage;
+	UPROPERTY()
+	float Duration = 0.f;
+	UPROPERTY()
+	bool bUpToPeak = false;
+	UPROPERTY()
+	FVector2f ForwardRange = FVector2f(0.f, 1.f);
+	UPROPERTY()
+	FVector2f UpRange = FVector2f(0.f, 1.f);
+	UPROPERTY()
+	TArray<uint16> Forward;
+	UPROPERTY()
+	TArray<uint16> Up;
+#if WITH_EDITORONLY_DATA
+	// Root translation at evenly spaced points of the montage, compared in editor builds to catch montages edited after
+	// the bake; cooked builds trust the asset and never extract root motion
+	UPROPERTY()
+	TArray<FVector3f> Fingerprint;
+#endif
+	
+	FORCEINLINE bool IsValid() const { return Forward.Num() >= 2 && Forward.Num() == Up.Num(); }
+	float SampleForward(float Alpha) const { return Sample(Forward, ForwardRange, Alpha); }
+	float SampleUp(float Alpha) const { return Sample(Up, UpRange, Alpha); }
+	
+	static uint16 Quantize(float Value, const FVector2f& Range);
+	static float Dequantize(uint16 Value, const FVector2f& Range);
+#if WITH_EDITOR
+	bool MatchesMontage(const UAnimMontage* InMontage) const;
+	static void ComputeFingerprint(const UAnimMontage* InMontage, TArray<FVector3f>& OutFingerprint);
+#endif
+
+private:
+#if WITH_EDITOR
+	static constexpr int32 NumFingerprintSamples = 4;
+	static constexpr float FingerprintTolerance = 1.f;
+	
+	// Last montage checked against the fingerprint, so it is only extracted once
+	mutable TWeakObjectPtr<const UAnimMontage> CheckedMontage;
+	mutable bool bCheckedMontageMatches = false;
+#endif
+	
+	static float Sample(const TArray<uint16>& Samples, const FVector2f& Range, float Alpha);
+};
+
+/**
+ * Vault trajectories baked from the character's montages by UVaultCurveBakeCommandlet, one per EVaultType.
+ */
+UCLASS()
+class VSLICES_API UVaultRootMotionCurves : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr int32 NumVaultTypes = 4;
+	
+	UPROPERTY(VisibleAnywhere, Category = "Vault")
+	FVaultRootMotionCurve Curves[NumVaultTypes];
+	
+	// Null when the type was not baked for this montage, or, in editor builds, when the montage changed since the bake
+	const FVaultRootMotionCurve* Find(EVaultType VaultType, const UAnimMontage* Montage) const;
+	
+	static const TCHAR* PackageName;
+	static FSoftObjectPath GetDefaultPath();
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameMode/VSlicesGameMode.h"
+#include "ParkourStats.h"
+#include "ParkourBenchmarkGameMode.generated.h"
+
+class AVSlicesCharacter;
+
+UENUM()
+enum class EParkourBenchmarkAction : uint8
+{
+	MoveForward,
+	StopMoving,
+	Sprint,
+	StopSprint,
+	Crouch,
+	StopCrouch,
+	Jump,
+	StopJump,
+	Grapple
+};
+
+USTRUCT()
+struct FParkourBenchmarkStep
+{
+	GENERATED_BODY()
+
+	FParkourBenchmarkStep() = default;
+	FParkourBenchmarkStep(const int32 InFrame, const EParkourBenchmarkAction InAction) : Frame(InFrame), Action(InAction) {}
+
+	// Frame inside the script loop at which the action fires
+	UPROPERTY(EditAnywhere)
+	int32 Frame = 0;
+	UPROPERTY(EditAnywhere)
+	EParkourBenchmarkAction Action = EParkourBenchmarkAction::MoveForward;
+};
+
+/**
+ * Headless benchmark for the parkour stack.
+ * Spawns NumRunners characters that loop a scripted input stream for a fixed number of fixed-step frames,
+ * then writes per-frame CSV and a JSON summary to Saved/Benchmarks and exits.
+ * Run with: VSlices Parkour?game=ParkourBenchmark -game -nullrhi -unattended -BenchRunners=64 -BenchFrames=3000
+ */
+UCLASS()
+class VSLICES_API AParkourBenchmarkGameMode : public AVSlicesGameMode
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditDefaultsOnly, Category = "Benchmark")
+	TSubclassOf<AVSlicesCharacter> RunnerClass;
+	UPROPERTY(EditDefaultsOnly, Category = "Benchmark")
+	int32 NumRunners = 32;
+	UPROPERTY(EditDefaultsOnly, Category = "Benchmark")
+	int32 WarmupFrames = 60;
+	UPROPERTY(EditDefaultsOnly, Category = "Benchmark")
+	int32 BenchmarkFrames = 1800;
+	UPROPERTY(EditDefaultsOnly, Category = "Benchmark")
+	float FixedDeltaTime = 1.f / 60.f;
+	UPROPERTY(EditDefaultsOnly, Category = "Benchmark")
+	bool bUseParkourSimulation = false;
+	UPROPERTY(EditDefaultsOnly, Category = "Benchmark")
+	float RunnerSpacing = 300.f;
+	// Frames between consecutive runners' script start, so the crowd does not act in lockstep
+	UPROPERTY(EditDefaultsOnly, Category = "Benchmark")
+	int32 RunnerStagger = 7;
+	UPROPERTY(EditDefaultsOnly, Category = "Benchmark")
+	int32 RandomSeed = 1337;
+	UPROPERTY(EditDefaultsOnly, Category = "Benchmark")
+	int32 ScriptLength = 360;
+	UPROPERTY(EditDefaultsOnly, Category = "Benchmark")
+	TArray<FParkourBenchmarkStep> Script;
+
+public:
+	AParkourBenchmarkGameMode();
+
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+	virtual void Tick(float DeltaSeconds) override;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	struct FBenchmarkFrame
+	{
+		double FrameSeconds;
+		uint64 TickCycles[FParkourBenchmarkStats::NumChannels];
+		int32 Queries[FParkourBenchmarkStats::NumChannels];
+		uint64 UsedPhysical;
+	};
+
+	struct FRunner
+	{
+		TWeakObjectPtr<AVSlicesCharacter> Character;
+		bool bMoving = false;
+	};
+
+	TArray<FRunner> Runners;
+	TArray<FBenchmarkFrame> Frames;
+	int32 CurrentFrame = 0;
+	double LastFrameTime = 0.0;
+	uint64 StartUsedPhysical = 0;
+	bool bFinished = false;
+	bool bWasFixedTimeStep = false;
+	double PreviousFixedDeltaTime = 0.0;
+	FString ReportName = TEXT("ParkourBenchmark");
+
+	void SpawnRunners();
+	void DriveRunner(FRunner& Runner, int32 ScriptFrame) const;
+	static void ApplyAction(FRunner& Runner, EParkourBenchmarkAction Action);
+	void StartRecording();
+	void RecordFrame();
+	void Finish();
+	void WriteReport() const;
+	FString GetReportPath(const TCHAR* Extension) const;
+};
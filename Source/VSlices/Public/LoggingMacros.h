@@ -2,7 +2,59 @@
 
 // Include the standard UE log header if not already
 #include "CoreMinimal.h"
+#include "CoreGlobals.h"
 
-#define LOG_WARNING(Format, ...) UE_LOG(LogTemp, Warning, TEXT(Format), ##__VA_ARGS__)
-#define LOG_ERROR(Format, ...)   UE_LOG(LogTemp, Error, TEXT(Format), ##__VA_ARGS__)
-#define LOG_INFO(Format, ...)    UE_LOG(LogTemp, Display, TEXT(Format), ##__VA_ARGS__)
+// Levels above this compile to nothing, argument evaluation included. Override from the target with PublicDefinitions
+#ifndef VSLICES_LOG_COMPILE_VERBOSITY
+	#if UE_BUILD_SHIPPING || UE_BUILD_TEST
+		#define VSLICES_LOG_COMPILE_VERBOSITY Warning
+	#else
+		#define VSLICES_LOG_COMPILE_VERBOSITY All
+	#endif
+#endif
+
+// One category per subsystem, so each can be raised at runtime with `log LogParkourVault Verbose`
+VSLICES_API DECLARE_LOG_CATEGORY_EXTERN(LogParkour, Log, VSLICES_LOG_COMPILE_VERBOSITY);
+VSLICES_API DECLARE_LOG_CATEGORY_EXTERN(LogParkourMovement, Log, VSLICES_LOG_COMPILE_VERBOSITY);
+VSLICES_API DECLARE_LOG_CATEGORY_EXTERN(LogParkourVault, Log, VSLICES_LOG_COMPILE_VERBOSITY);
+VSLICES_API DECLARE_LOG_CATEGORY_EXTERN(LogParkourWallRun, Log, VSLICES_LOG_COMPILE_VERBOSITY);
+VSLICES_API DECLARE_LOG_CATEGORY_EXTERN(LogParkourGrapple, Log, VSLICES_LOG_COMPILE_VERBOSITY);
+VSLICES_API DECLARE_LOG_CATEGORY_EXTERN(LogParkourLedge, Log, VSLICES_LOG_COMPILE_VERBOSITY);
+VSLICES_API DECLARE_LOG_CATEGORY_EXTERN(LogParkourWorld, Log, VSLICES_LOG_COMPILE_VERBOSITY);
+VSLICES_API DECLARE_LOG_CATEGORY_EXTERN(LogParkourBenchmark, Log, VSLICES_LOG_COMPILE_VERBOSITY);
+VSLICES_API DECLARE_LOG_CATEGORY_EXTERN(LogParkourInput, Log, VSLICES_LOG_COMPILE_VERBOSITY);
+
+// Verbose is off at runtime by default: use it for per-attempt detail on hot paths
+#define LOG_VERBOSE(Category, Format, ...) UE_LOG(Category, Verbose, TEXT(Format), ##__VA_ARGS__)
+#define LOG_INFO(Category, Format, ...)    UE_LOG(Category, Display, TEXT(Format), ##__VA_ARGS__)
+#define LOG_WARNING(Category, Format, ...) UE_LOG(Category, Warning, TEXT(Format), ##__VA_ARGS__)
+#define LOG_ERROR(Category, Format, ...)   UE_LOG(Category, Error, TEXT(Format), ##__VA_ARGS__)
+
+// Caps how often one call site may print per frame; game thread only
+struct FLogRateLimiter
+{
+	uint64 Frame = 0;
+	int32 Count = 0;
+
+	FORCEINLINE bool Allow(const int32 MaxPerFrame)
+	{
+		if (Frame != GFrameCounter)
+		{
+			Frame = GFrameCounter;
+			Count = 0;
+		}
+		return ++Count <= MaxPerFrame;
+	}
+};
+
+// For messages still wanted when many characters hit the same path in one frame
+#define LOG_RATE_LIMITED(Category, Verbosity, MaxPerFrame, Format, ...) \
+	do \
+	{ \
+		if (UE_LOG_ACTIVE(Category, Verbosity)) \
+		{ \
+			static FLogRateLimiter LogRateLimiter; \
+			if (LogRateLimiter.Allow(MaxPerFrame)) \
+				UE_LOG(Category, Verbosity, TEXT(Format), ##__VA_ARGS__); \
+		} \
+	} while (0)
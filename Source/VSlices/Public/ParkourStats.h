@@ -0,0 +1,116 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Subsystems/ParkourSimulationSubsystem.h"
+
+// `stat Parkour` in game; the same scopes show up in Unreal Insights on the cpu channel
+DECLARE_STATS_GROUP(TEXT("Parkour"), STATGROUP_Parkour, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Vault Tick"), STAT_ParkourVaultTick, STATGROUP_Parkour, VSLICES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("WallRun Tick"), STAT_ParkourWallRunTick, STATGROUP_Parkour, VSLICES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Grapple Tick"), STAT_ParkourGrappleTick, STATGROUP_Parkour, VSLICES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("LedgeSwing Tick"), STAT_ParkourLedgeSwingTick, STATGROUP_Parkour, VSLICES_API);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Vault Query"), STAT_ParkourVaultQuery, STATGROUP_Parkour, VSLICES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("WallRun Query"), STAT_ParkourWallRunQuery, STATGROUP_Parkour, VSLICES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Grapple Query"), STAT_ParkourGrappleQuery, STATGROUP_Parkour, VSLICES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("LedgeSwing Query"), STAT_ParkourLedgeSwingQuery, STATGROUP_Parkour, VSLICES_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Vault Queries"), STAT_ParkourVaultQueries, STATGROUP_Parkour, VSLICES_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("WallRun Queries"), STAT_ParkourWallRunQueries, STATGROUP_Parkour, VSLICES_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Grapple Queries"), STAT_ParkourGrappleQueries, STATGROUP_Parkour, VSLICES_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("LedgeSwing Queries"), STAT_ParkourLedgeSwingQueries, STATGROUP_Parkour, VSLICES_API);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Simulation Compute"), STAT_ParkourSimulationCompute, STATGROUP_Parkour, VSLICES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Simulation Apply"), STAT_ParkourSimulationApply, STATGROUP_Parkour, VSLICES_API);
+
+VSLICES_API TStatId GetParkourTickStatId(EParkourSimChannel Channel);
+
+#if STATS
+#define PARKOUR_QUERY_STAT_SCOPE(Channel) \
+	SCOPE_CYCLE_COUNTER(STAT_Parkour##Channel##Query); \
+	INC_DWORD_STAT(STAT_Parkour##Channel##Queries)
+#define PARKOUR_TICK_STAT_SCOPE(Channel) \
+	FScopeCycleCounter ParkourTickCycles(GetParkourTickStatId(Channel))
+#else
+#define PARKOUR_QUERY_STAT_SCOPE(Channel) \
+	TRACE_CPUPROFILER_EVENT_SCOPE(Parkour##Channel##Query)
+#define PARKOUR_TICK_STAT_SCOPE(Channel) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT(FParkourBenchmarkStats::GetChannelName(Channel))
+#endif
+
+// Per-component tick: stat, Insights scope and benchmark timing
+#define PARKOUR_TICK_SCOPE(Channel) \
+	PARKOUR_TICK_STAT_SCOPE(Channel); \
+	FParkourBenchmarkScope ParkourTickBenchmark(Channel)
+
+/**
+ * Wraps one physics query inside a UParkourComponentBase and evaluates to its result:
+ *   if (PARKOUR_QUERY(Vault, GetWorld()->LineTraceSingleByChannel(...)))
+ * Times and counts the query and charges it to the component's per-frame budget.
+ */
+#define PARKOUR_QUERY(Channel, ...) \
+	[&]() \
+	{ \
+		PARKOUR_QUERY_STAT_SCOPE(Channel); \
+		RecordQuery(); \
+		return __VA_ARGS__; \
+	}()
+
+// Physics queries issued by one component, for budgeting
+struct FParkourQueryBudget
+{
+	uint64 Frame = 0;       // latest frame that issued queries
+	int32 FrameQueries = 0; // queries issued in that frame
+	int32 Peak = 0;
+	int32 Total = 0;
+	int32 OverBudgetFrames = 0;
+	double StartTime = 0.0;
+};
+
+/**
+ * Process-wide counters filled by the parkour stack while AParkourBenchmarkGameMode is recording.
+ * Recording is off outside the benchmark, so each hook costs one branch.
+ * Updates are atomic because ComputeTick can run on worker threads in the crowd simulation.
+ */
+struct VSLICES_API FParkourBenchmarkStats
+{
+	static constexpr int32 NumChannels = static_cast<int32>(EParkourSimChannel::Num);
+
+	static void StartRecording();
+	static void StopRecording();
+	static void Reset();
+	FORCEINLINE static bool IsRecording() { return bRecording; }
+
+	static void AddTickCycles(EParkourSimChannel Channel, uint64 Cycles);
+	static void AddQuery(EParkourSimChannel Channel);
+
+	static uint64 GetTickCycles(EParkourSimChannel Channel);
+	static int32 GetQueryCount(EParkourSimChannel Channel);
+	static const TCHAR* GetChannelName(EParkourSimChannel Channel);
+
+private:
+	static bool bRecording;
+	static int64 TickCycles[NumChannels];
+	static int32 QueryCounts[NumChannels];
+};
+
+// Times the enclosing scope into a channel's tick cycles while recording
+class FParkourBenchmarkScope
+{
+public:
+	explicit FParkourBenchmarkScope(const EParkourSimChannel InChannel)
+		: Channel(InChannel), StartCycles(FParkourBenchmarkStats::IsRecording() ? FPlatformTime::Cycles64() : 0) {}
+
+	~FParkourBenchmarkScope()
+	{
+		if (StartCycles)
+			FParkourBenchmarkStats::AddTickCycles(Channel, FPlatformTime::Cycles64() - StartCycles);
+	}
+
+private:
+	EParkourSimChannel Channel;
+	uint64 StartCycles;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GrapplePointSubsystem.generated.h"
+
+// Aim-assist search around the view direction; candidates are ranked by angle off the crosshair and distance
+struct FGrapplePointQuery
+{
+	FVector Origin = FVector::ZeroVector;
+	FVector Direction = FVector::ForwardVector; // unit length
+	float Range = 0.f;
+	float CosConeAngle = 1.f;
+	float AngleWeight = 1.f;
+	float DistanceWeight = 0.f;
+	float MinDistance = 0.f;
+	// Ledge points must be at least this far above Origin; tagged anchors are always candidates
+	float MinLedgeHeight = 0.f;
+};
+
+/**
+ * Grapple targets of the current world in a 2D spatial grid: actors tagged GrapplePoint plus points along the edges
+ * of every wall top in the baked affordance index that stands at least MinLedgeWallHeight tall. Built on the first
+ * query after anything changed.
+ */
+UCLASS()
+class VSLICES_API UGrapplePointSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static const FName AnchorTag;
+	
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	
+	// For anchors spawned after BeginPlay; anchors are expected to stay where they were registered
+	void RegisterAnchor(AActor* Anchor);
+	void UnregisterAnchor(AActor* Anchor);
+	
+	// Best candidate inside the query's cone, without any visibility check
+	bool FindBestCandidate(const FGrapplePointQuery& Query, FVector& OutLocation) const;
+	
+	FORCEINLINE int32 NumPoints() const { return Points.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	static constexpr float CellSize = 1000.f;
+	// Spacing of the candidate points laid along wall-top edges
+	static constexpr float LedgePointSpacing = 200.f;
+	// Floor slabs, kerbs and knee-high boxes are in the affordance index too, but nobody grapples onto them
+	static constexpr float MinLedgeWallHeight = 150.f;
+	
+	TArray<TWeakObjectPtr<AActor>> Anchors;
+	mutable TArray<FVector> Points; // anchors first, then ledge points
+	mutable int32 NumAnchorPoints = 0;
+	mutable TMap<FIntPoint, TArray<int32>> Cells;
+	mutable bool bDirty = true;
+	
+	void Rebuild() const;
+	void AddPoint(const FVector& Location) const;
+	static FIntPoint ToCell(const FVector2D& Location);
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ParkourAffordanceSubsystem.generated.h"
+
+class UParkourAffordanceIndex;
+
+enum class EParkourAffordanceQuery : uint8
+{
+	Found,   // answered from the baked index
+	None,    // the index fully describes the static geometry here and it has no affordance, only dynamic geometry needs tracing
+	Unknown  // no index, or the query leaves the baked cells or touches unbaked geometry, trace everything
+};
+
+/**
+ * Answers vault/ledge/pole detection queries from the baked UParkourAffordanceIndex of the current map using a 2D spatial hash.
+ */
+UCLASS()
+class VSLICES_API UParkourAffordanceSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	
+	// Highest wall top under Start, between Start.Z and EndZ (same as a downward trace)
+	EParkourAffordanceQuery FindWallTop(const FVector& Start, const float EndZ, float& OutTopZ) const;
+	// First ledge hit by a horizontal ray at Start.Z, with its top inside [MinTopZ, MaxTopZ]
+	EParkourAffordanceQuery FindLedge(const FVector& Start, const FVector& Direction, const float Reach, const float MinTopZ, const float MaxTopZ, FVector& OutLocation) const;
+	// Lowest pole directly above Start, with its underside inside [MinZ, MaxZ]
+	EParkourAffordanceQuery FindPole(const FVector& Start, const float MinZ, const float MaxZ, FVector& OutLocation, FVector& OutNormal) const;
+	
+	FORCEINLINE bool HasIndex() const { return Index != nullptr; }
+	FORCEINLINE const UParkourAffordanceIndex* GetIndex() const { return Index; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FCell
+	{
+		TArray<int32> WallTops;
+		TArray<int32> Poles;
+		bool bOpaque = false;
+	};
+	
+	static constexpr float CellSize = 200.f;
+	
+	UPROPERTY()
+	UParkourAffordanceIndex* Index;
+	TMap<FIntPoint, FCell> Cells;
+	
+	void BuildCells();
+	void GatherCells(const FVector2D& Min, const FVector2D& Max, TArray<const FCell*>& OutCells, bool& bOutCovered) const;
+	static FIntPoint ToCell(const FVector2D& Location);
+};
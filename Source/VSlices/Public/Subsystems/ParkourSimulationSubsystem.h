@@ -0,0 +1,85 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ParkourSimulationSubsystem.generated.h"
+
+class UParkourComponentBase;
+class AVSlicesCharacter;
+class ACharacter;
+
+// Owner state read once on the game thread and handed to the thread-safe compute step
+struct FParkourRunnerState
+{
+	FVector Location = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+	FRotator Rotation = FRotator::ZeroRotator;
+	
+	static FParkourRunnerState Capture(const ACharacter* Character);
+};
+
+// Parkour components that tick; one column per channel in the simulation
+enum class EParkourSimChannel : uint8
+{
+	Vault,
+	WallRun,
+	Grapple,
+	LedgeSwing,
+	Num,
+	None = Num
+};
+
+/**
+ * Opt-in crowd path for parkour ticking. Characters with bUseParkourSimulation register their components here
+ * instead of ticking them; per-runner state is kept in contiguous arrays and all runners advance in one pass.
+ * Each pass gathers runner state, runs the math-only ComputeTick of every due component in a ParallelFor,
+ * then applies the actor writes on the game thread.
+ */
+UCLASS()
+class VSLICES_API UParkourSimulationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override { return Runners.Num() > 0; }
+	virtual void Deinitialize() override;
+	
+	void Register(UParkourComponentBase* Component, EParkourSimChannel Channel);
+	void Unregister(UParkourComponentBase* Component, EParkourSimChannel Channel);
+	void SetActive(const AVSlicesCharacter* Character, EParkourSimChannel Channel, bool bActive);
+	
+	FORCEINLINE int32 NumRunners() const { return Runners.Num(); }
+
+private:
+	struct FParkourSimStep
+	{
+		UParkourComponentBase* Component;
+		float DeltaTime;
+		int32 Slot;
+		EParkourSimChannel Channel;
+	};
+	
+	static constexpr int32 NumChannels = static_cast<int32>(EParkourSimChannel::Num);
+	static constexpr int32 MinParallelBatchSize = 16;
+	
+	// Structure of arrays, indexed by runner slot. Components unregister in EndPlay; a runner or component destroyed
+	// without it is only referenced weakly and dropped on the next Tick
+	TArray<TWeakObjectPtr<AVSlicesCharacter>> Runners;
+	TArray<uint8> ActiveMasks;
+	TArray<TWeakObjectPtr<UParkourComponentBase>> Components[NumChannels];
+	TArray<float> Accumulators[NumChannels];
+	TArray<float> Intervals[NumChannels];
+	
+	TArray<FParkourRunnerState> RunnerStates;
+	
+	TMap<TWeakObjectPtr<const AVSlicesCharacter>, int32> SlotLookup;
+	// Reused every frame to avoid reallocating the work list
+	TArray<FParkourSimStep> Steps;
+	
+	int32 FindOrAddSlot(AVSlicesCharacter* Character);
+	void RemoveSlot(int32 Slot);
+	void RemoveStaleSlots();
+};
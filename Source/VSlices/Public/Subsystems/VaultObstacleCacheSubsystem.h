@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "VaultObstacleCacheSubsystem.generated.h"
+
+// Geometry of an analyzed obstacle, independent of who is vaulting it. Landing space is not cached: anything standing
+// on the obstacle can block it without moving the obstacle itself
+struct FVaultObstacleCacheEntry
+{
+	float TopZ = 0.f;
+	bool bHasTop = false;    // false = wall top trace found nothing
+	bool bAnalyzed = false;  // thickness has been traced
+	bool bIsThick = false;
+};
+
+struct FVaultObstacleCacheKey
+{
+	TWeakObjectPtr<UPrimitiveComponent> Component;
+	FIntVector Cell;
+	FIntVector NormalCell;   // wall top and thickness only depend on where the wall was hit and which way it faces
+
+	bool operator==(const FVaultObstacleCacheKey& Other) const
+	{
+		return Component == Other.Component && Cell == Other.Cell && NormalCell == Other.NormalCell;
+	}
+	friend uint32 GetTypeHash(const FVaultObstacleCacheKey& Key)
+	{
+		const uint32 Hash = HashCombine(GetTypeHash(Key.Component), GetTypeHash(Key.Cell));
+		return HashCombine(Hash, GetTypeHash(Key.NormalCell));
+	}
+};
+
+/**
+ * Shares UVaultComponent obstacle geometry (wall top, thickness) between all characters in a world.
+ * Entries are keyed by hit component and quantized hit location and dropped when that component moves.
+ */
+UCLASS()
+class VSLICES_API UVaultObstacleCacheSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	
+	bool FindObstacle(const FHitResult& Hit, FVaultObstacleCacheEntry& OutEntry) const;
+	void StoreObstacle(const FHitResult& Hit, const FVaultObstacleCacheEntry& Entry);
+	void InvalidateComponent(const UPrimitiveComponent* Component);
+	
+	FORCEINLINE int32 Num() const { return Entries.Num(); }
+
+private:
+	static constexpr float CellSize = 16.f;
+	static constexpr float NormalResolution = 8.f;
+	static constexpr int32 MaxEntries = 8192;
+	
+	TMap<FVaultObstacleCacheKey, FVaultObstacleCacheEntry> Entries;
+	TMap<TWeakObjectPtr<USceneComponent>, FDelegateHandle> WatchedComponents;
+	
+	static bool MakeKey(const FHitResult& Hit, FVaultObstacleCacheKey& OutKey);
+	void WatchComponent(UPrimitiveComponent* Component);
+	void OnComponentTransformUpdated(USceneComponent* Component, EUpdateTransformFlags UpdateFlags, ETeleportType Teleport);
+	void Reset();
+};